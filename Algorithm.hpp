@@ -1,12 +1,117 @@
-
-#ifndef ALGORITHM_HPP
-#define ALGORITHM_HPP
 /** @file onion/Algorithm.hpp
  *  @brief This header declares the Algorithm interface of the Onion Framework.
  *  <hr>
  *  @copyright 2022 André Ladeira / Onion Framework.
  */
+#ifndef ALGORITHM_HPP
+#define ALGORITHM_HPP
+
+#include "ComponentID.hpp"
+#include "NonCopyable.hpp"
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+namespace onion{
+
+/**
+ * @brief Stopping criteria of a search. The search stops as soon as one of them is met.
+ */
+struct budget_t{
+    std::uint64_t evaluations = std::numeric_limits<std::uint64_t>::max();  ///< number of solutions or neighbours evaluated
+    double        seconds     = std::numeric_limits<double>::infinity();    ///< wall-clock time
+    std::uint64_t stagnation  = std::numeric_limits<std::uint64_t>::max();  ///< evaluations since the last improvement
+};
+
+/**
+ * @brief Counters of a search.
+ */
+struct search_stats_t{
+    std::uint64_t evaluations      = 0;  ///< solutions or neighbours evaluated
+    std::uint64_t moves            = 0;  ///< moves applied
+    std::uint64_t last_improvement = 0;  ///< value of evaluations when the best solution last improved
+    double        seconds          = 0;  ///< wall-clock time
+
+    /**
+     * @brief Evaluations per second, 0 if no time was measured.
+     */
+    double evaluations_per_second() const noexcept { return seconds > 0 ? evaluations / seconds : 0; }
+};
+
+/** @class Algorithm
+ *  @brief Abstract Data Type that defines the Algorithm component.
+ *  @param solution_t the type used to represent a solution to a problem.
+ *  @param objective_value_t the type used to represent the value of a solution.
+ *
+ *  An Algorithm combines the other components to search the solution space. Whatever the algorithm,
+ *  a search is a sequence of steps that starts from an initial state:
+ *
+ *  - init() creates the initial state: the starting solutions, their values, the parameters of the search.
+ *  - step() advances the search by one iteration. What an iteration is depends on the algorithm
+ *    (a temperature level, a generation, ...): it should be long enough to make the cost of the call
+ *    negligible, and short enough to check the budget often.
+ *  - run() calls init(), then step() until the budget is exhausted or the algorithm ends.
+ *
+ *  The best solution found so far, and its value, are available after every step.
+ *  Implementations update the counters returned by stats(); run() measures the time.
+ *
+ *  @note
+ *  Algorithm is an <a href="./md__glossary.html#abstract_data_type">Abstract Data Type</a>.
+ *  Actual functionality will be defined later by concrete implementions in derived classes.
+ */
+template< typename solution_t, typename objective_value_t >
+class Algorithm : public NonCopyable, public virtual ComponentID
+{
+public:
+    /**
+     * @brief Class destructor.
+     */
+    virtual ~Algorithm() = default;
+    /**
+     * @brief Creates the initial state of the search and resets the counters.
+     */
+    virtual void init() = 0;
+    /**
+     * @brief Performs one iteration of the search.
+     * @return false if the algorithm has ended, true otherwise.
+     */
+    virtual bool step() = 0;
+    /**
+     * @brief Initializes the search and performs steps until the budget is exhausted or the algorithm ends.
+     * @param [in] budget the stopping criteria. They are checked between steps.
+     */
+    virtual void run(const budget_t& budget){
+        using clock = std::chrono::steady_clock;
+        const auto start = clock::now();
+        init();
+        for (;;){
+            _stats.seconds = std::chrono::duration<double>( clock::now() - start ).count();
+            if ( _stats.evaluations >= budget.evaluations || _stats.seconds >= budget.seconds ||
+                 _stats.evaluations - _stats.last_improvement >= budget.stagnation ) break;
+            if ( !step() ) break;
+        }
+        _stats.seconds = std::chrono::duration<double>( clock::now() - start ).count();
+    }
+    /**
+     * @brief The best solution found so far.
+     */
+    virtual const solution_t& best() const = 0;
+    /**
+     * @brief The value of the best solution found so far.
+     */
+    virtual objective_value_t best_value() const = 0;
+    /**
+     * @brief The counters of the search.
+     */
+    const search_stats_t& stats() const noexcept { return _stats; }
 
+protected:
+    /**
+     * @brief The counters of the search, updated by the implementations.
+     */
+    search_stats_t _stats;
+};
 
+}
 
 #endif // ALGORITHM_HPP
@@ -0,0 +1,73 @@
+/** @file onion/AlignedAllocator.hpp
+ *  @brief Contains the definition of the AlignedAllocator class.
+ *  <hr>
+ *  @copyright 2022 André Ladeira / Onion Framework.
+ */
+#ifndef ALIGNEDALLOCATOR_HPP
+#define ALIGNEDALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace onion{
+
+/** @class AlignedAllocator
+ *  @brief Standard allocator that returns memory aligned to a given boundary (a cache line by default).
+ *  @param T the type of the allocated elements.
+ *  @param alignment the alignment in bytes: a power of two, at least sizeof(void*).
+ *
+ *  Containers such as `std::vector< T, AlignedAllocator<T> >` keep their data on the heap, starting at
+ *  a cache line boundary. Scans over the data then touch the minimum number of cache lines and
+ *  SIMD code can use aligned loads.
+ *
+ *  C++14 has no aligned `operator new`, so the allocator over-allocates by `alignment` bytes
+ *  and stores the pointer returned by `operator new` just before the aligned block.
+ */
+template< typename T, std::size_t alignment = 64 >
+class AlignedAllocator
+{
+    static_assert( ( alignment & ( alignment - 1 ) ) == 0, "alignment must be a power of two" );
+    static_assert( alignment >= sizeof(void*), "alignment must be at least sizeof(void*)" );
+
+public:
+
+    using value_type = T;
+
+    template< typename U > struct rebind { using other = AlignedAllocator<U, alignment>; };
+
+    AlignedAllocator() noexcept = default;
+
+    template< typename U >
+    AlignedAllocator(const AlignedAllocator<U, alignment>&) noexcept {}
+
+    /**
+     * @brief Allocates uninitialized storage for n objects of type T.
+     * @param [in] n the number of objects.
+     * @return A pointer aligned to `alignment` bytes.
+     */
+    T* allocate(std::size_t n){
+        void* raw = ::operator new( n * sizeof(T) + alignment );
+        const std::uintptr_t aligned = ( reinterpret_cast<std::uintptr_t>(raw) + alignment ) & ~std::uintptr_t( alignment - 1 );
+        reinterpret_cast<void**>(aligned)[-1] = raw;
+        return reinterpret_cast<T*>(aligned);
+    }
+
+    /**
+     * @brief Releases storage obtained from allocate().
+     * @param [in] p the pointer returned by allocate().
+     */
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete( reinterpret_cast<void**>(p)[-1] );
+    }
+};
+
+template< typename T, typename U, std::size_t alignment >
+inline bool operator==(const AlignedAllocator<T, alignment>&, const AlignedAllocator<U, alignment>&) noexcept { return true; }
+
+template< typename T, typename U, std::size_t alignment >
+inline bool operator!=(const AlignedAllocator<T, alignment>&, const AlignedAllocator<U, alignment>&) noexcept { return false; }
+
+}
+
+#endif // ALIGNEDALLOCATOR_HPP
@@ -74,6 +74,15 @@ public:
  *  ObjectiveFunction and SelectOperator) must inherit from ComponentID in order to be identifiable within
  *  the framework.
  *
+ *  The component interfaces inherit ComponentID virtually. Therefore, concrete components initialize it
+ *  directly, even if they implement more than one interface:
+ *
+ *      class CreateRandom : public CreateOperator< path_t<10> >{
+ *      public:
+ *          CreateRandom() : ComponentID( IDBuilder().name("CreateRandom")
+ *                                                   .type("Create Operator") ){}
+ *          ...
+ *      };
  *
  */
 class ComponentID
@@ -111,7 +120,7 @@ private:
  *  @param [in] id a constant reference to the component whose ID is to be printed.
  *  @return the os output stream, so it can be used in sequence.
  */
-std::ostream& operator<<(std::ostream& os, const ComponentID& id){
+inline std::ostream& operator<<(std::ostream& os, const ComponentID& id){
     os << "Name          : " << id._id.name << std::endl;
     os << "Type          : " << id._id.type << std::endl;
     os << "Description   : " << id._id.description << std::endl;
@@ -125,7 +134,7 @@ std::ostream& operator<<(std::ostream& os, const ComponentID& id){
  *  @param [in] id a constant pointer to the component whose ID is to be printed.
  *  @return The os output stream, so it can be in sequence.
  */
-std::ostream& operator<<(std::ostream& os, const ComponentID* const id ){
+inline std::ostream& operator<<(std::ostream& os, const ComponentID* const id ){
    return operator<<(os,*id);
 }
 
@@ -33,7 +33,7 @@ namespace onion{
  *  Actual functionality will be defined later by concrete implementions in derived classes.
  *
  */
-template< typename solution_t > class CreateOperator : public NonCopyable, public ComponentID
+template< typename solution_t > class CreateOperator : public NonCopyable, public virtual ComponentID
 {
 public:
     /**
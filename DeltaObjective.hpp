@@ -0,0 +1,62 @@
+/** @file onion/DeltaObjective.hpp
+ *  @brief This header introduces the DeltaObjective class interface.
+ *  <hr>
+ *  @copyright 2022 André Ladeira / Onion Framework.
+ */
+#ifndef DELTAOBJECTIVE_HPP
+#define DELTAOBJECTIVE_HPP
+
+#include "NonCopyable.hpp"
+#include "ComponentID.hpp"
+
+namespace onion{
+
+/** @class DeltaObjective
+ *  @brief Abstract Data Type that defines the DeltaObjective component.
+ *  @param solution_t the type used to represent a solution to a problem.
+ *  @param parameter_t the type of the transformation parameters created by a ParameterOperator.
+ *  @param objective_value_t the type used to represent the value of a solution.
+ *
+ *  A DeltaObjective function calculates the *difference* in the value of a solution **S**
+ *  caused by a transformation <b>τ(S,P<sub>i</sub>)</b>, without creating the transformed solution:
+ *
+ *  <b>v<sub>i</sub> = v + Δ( S, P<sub>i</sub> )</b>
+ *
+ *  It is, along with the ParameterOperator, one of the
+ *  <a href="./md__glossary.html#adt">delta components</a> of the Onion Framework.
+ *  The ParameterOperator creates the parameters P<sub>i</sub>, the DeltaObjective tells
+ *  how good the potential solutions are. See the
+ *  <a href="./classonion_1_1_parameter_operator.html#ParameterOperator_bk">ParameterOperator background</a>
+ *  for a complete discussion.
+ *
+ *  The cost of an ObjectiveFunction call is, at least, proportional to the size of the solution.
+ *  Most transformations change only a few components of a solution, so their DeltaObjective
+ *  is **O(1)**. For example, a 2-opt move on a TSP tour removes two edges and adds two edges,
+ *  whatever the number of cities.
+ *
+ *  @note
+ *  DeltaObjective is an <a href="./md__glossary.html#abstract_data_type">Abstract Data Type</a>.
+ *  It means it provides no functionality and can't be instantiated.
+ *  Actual functionality will be defined later by concrete implementions in derived classes.
+ *
+ */
+template< typename solution_t, typename parameter_t, typename objective_value_t >
+class DeltaObjective : public NonCopyable, public virtual ComponentID
+{
+public:
+    /**
+     * @brief Class destructor.
+     */
+    virtual ~DeltaObjective() = default;
+    /**
+     * @brief Calculates the change in the value of a solution caused by a transformation.
+     * @param S the current solution.
+     * @param P the transformation parameter. It must be valid for S.
+     * @return The difference between the value of τ(S,P) and the value of S.
+     */
+    virtual objective_value_t operator()(const solution_t& S, const parameter_t& P) = 0;
+};
+
+}
+
+#endif // DELTAOBJECTIVE_HPP
@@ -0,0 +1,445 @@
+/** @file onion/IslandModel.hpp
+ *  @brief This header introduces the island model evolutionary algorithm.
+ *  <hr>
+ *  @copyright 2022 André Ladeira / Onion Framework.
+ */
+#ifndef ISLANDMODEL_HPP
+#define ISLANDMODEL_HPP
+
+#include "AlignedAllocator.hpp"
+#include "Algorithm.hpp"
+#include "ComparissonOperator.hpp"
+#include "CreateOperator.hpp"
+#include "ObjectiveFunction.hpp"
+#include "PerturbationOperator.hpp"
+#include "RandomStreams.hpp"
+#include "SelectOperator.hpp"
+#include "SpscQueue.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace onion{
+namespace algorithms{
+
+/**
+ * @brief The islands an island sends its migrants to.
+ */
+enum class topology_t{
+    ring,   ///< island i sends to island i + 1
+    torus,  ///< the islands form a rows x columns grid that wraps around; each one sends to its 4 neighbours
+    random  ///< each migration goes to an island drawn uniformly among the others
+};
+
+/**
+ * @brief Parameters of an IslandModel.
+ */
+struct island_config_t{
+    unsigned int  islands        = 4;                  ///< number of islands, when the components are shared
+    std::size_t   population     = 64;                 ///< solutions per island
+    std::size_t   offspring      = 64;                 ///< children per island and generation
+    topology_t    topology       = topology_t::ring;   ///< where the migrants go
+    unsigned int  interval       = 10;                 ///< generations between two migrations of an island
+    unsigned int  migrants       = 2;                  ///< solutions sent per destination and migration
+    std::size_t   queue_capacity = 8;                  ///< migrants waiting between two islands, at most
+};
+
+/** @class IslandModel
+ *  @brief Evolutionary algorithm on islands that evolve in parallel and exchange migrants.
+ *  @param solution_t the type used to represent a solution to a problem.
+ *  @param objective_value_t the type used to represent the value of a solution.
+ *  @param better the comparisson that defines an improvement: Less to minimize, Greater to maximize.
+ *
+ *  Each island holds a population, and a generation of an island:
+ *
+ *  1. chooses `offspring` parents with its SelectOperator and creates a child from each one with its
+ *     PerturbationOperator (the variation operator);
+ *  2. evaluates the children with a single ObjectiveFunction::evaluate() call;
+ *  3. replaces the worst solution of the population by each child that is better than it.
+ *
+ *  Every `interval` generations, an island sends copies of its best solution and of `migrants - 1`
+ *  solutions chosen by its SelectOperator to the islands of the topology, then takes in the migrants
+ *  it received, which replace its worst solutions when they are better.
+ *
+ *  The islands are spread over the threads of a ThreadPool: island i runs on thread i mod P, P being the
+ *  smaller of the pool size and the number of islands. Each island owns its population, the vectors of its
+ *  children and of their values, and its random engine (stream i of a RandomStreams, installed while the
+ *  island runs), all allocated by the constructor. The vectors are reused by every generation, but not the
+ *  children themselves: the variation operator returns each child by value, so a child that owns memory
+ *  (a std::vector) is allocated by the operator and moved into its slot. Each pair of islands connected by the topology has its own
+ *  SpscQueue, so the islands never wait for each other: a migration to a full queue is dropped, and the
+ *  migrants are taken in whenever they arrive. A run is therefore not reproducible when P > 1.
+ *
+ *  The budget is checked by each island after each of its generations. The evaluations are counted by all
+ *  islands together, and the stagnation is counted since the last improvement of the best solution of any
+ *  island.
+ *
+ *  The components are given per island (a create, objective, variation and select operator for each island),
+ *  or shared by all islands. Shared components are called concurrently: use them only when the calls made
+ *  here keep no state that changes (the MKP FlipItem, the TSP TourLength, for example), and give each island
+ *  its own instance of the others (the MKP CreateRandom, TwoOpt, LinKernighan). The islands only call
+ *  SelectOperator::select(), which a TournamentSelect can share; its operator() stores the choice for
+ *  selected() and cannot be shared.
+ *
+ *      using GA = IslandModel< Solution, std::int64_t, Greater<std::int64_t> >;
+ *      TournamentSelect< std::int64_t, Greater<std::int64_t> > select(2);
+ *      std::vector< GA::operators_t > islands;
+ *      for (auto& create : creates) islands.push_back( GA::operators_t{ &create, &profit, &flip, &select } );
+ *      GA ga(islands, config, pool);
+ *      ga.run(budget);
+ */
+template< typename solution_t, typename objective_value_t,
+          ComparissonOperator<objective_value_t> better = Less<objective_value_t> >
+class IslandModel : public Algorithm< solution_t, objective_value_t >
+{
+public:
+
+    using select_type    = SelectOperator< objective_value_t, std::vector<objective_value_t>, better >;
+    using variation_type = PerturbationOperator< solution_t, solution_t >;
+    /**
+     * @brief The components of an island.
+     */
+    struct operators_t{
+        CreateOperator<solution_t>*                       create;
+        ObjectiveFunction<solution_t, objective_value_t>* objective;
+        variation_type*                                   variation;
+        select_type*                                      select;
+    };
+    /**
+     * @brief Class constructor, for components shared by config.islands islands.
+     * @param [in] create creates the initial populations.
+     * @param [in] objective evaluates the solutions.
+     * @param [in] variation creates a child from a parent.
+     * @param [in] select chooses the parents and the migrants.
+     * @param [in] config the parameters.
+     * @param [in] pool the threads that run the islands.
+     * @param [in] seed the master seed of the random streams. 0 draws a seed from std::random_device.
+     *
+     * The components and the pool must outlive the algorithm.
+     */
+    IslandModel(CreateOperator<solution_t>& create, ObjectiveFunction<solution_t, objective_value_t>& objective,
+                variation_type& variation, select_type& select, const island_config_t& config,
+                ThreadPool& pool, RandomEngine::int_t seed = 0):
+        IslandModel( std::vector<operators_t>( std::max(1u, config.islands), operators_t{ &create, &objective, &variation, &select } ),
+                     config, pool, seed ){
+    }
+    /**
+     * @brief Class constructor, for components given per island.
+     * @param [in] operators the components of each island: one island per element. config.islands is ignored.
+     * @param [in] config the parameters.
+     * @param [in] pool the threads that run the islands.
+     * @param [in] seed the master seed of the random streams. 0 draws a seed from std::random_device.
+     */
+    IslandModel(const std::vector<operators_t>& operators, const island_config_t& config,
+                ThreadPool& pool, RandomEngine::int_t seed = 0):
+        ComponentID( IDBuilder()
+                    .name("IslandModel")
+                    .description("Evolutionary algorithm on islands with lock-free migration.")
+                    .type("Algorithm")
+                    .version("v0.1.0")),
+        _config(config),
+        _pool(pool),
+        _streams(seed),
+        _islands( operators.size() ){
+        _config.islands    = static_cast<unsigned int>( operators.size() );
+        _config.population = std::max<std::size_t>( 1, _config.population );
+        _config.offspring  = std::max<std::size_t>( 1, _config.offspring );
+        _config.interval   = std::max( 1u, _config.interval );
+        _config.migrants   = static_cast<unsigned int>( std::min<std::size_t>( _config.migrants, _config.population ) );
+
+        for (std::size_t i = 0; i < _islands.size(); ++i){
+            island_t& is = _islands[i];
+            is.ops = operators[i];
+            is.population.resize(_config.population);
+            is.values.resize(_config.population);
+            is.children.resize(_config.offspring);
+            is.child_values.resize(_config.offspring);
+        }
+        connect();
+    }
+
+    virtual void init(){
+        reset();
+        for (std::size_t i = 0; i < _islands.size(); ++i) init_island(i);
+        collect();
+    }
+    /**
+     * @brief Performs one generation on every island, in parallel.
+     */
+    virtual bool step(){
+        const unsigned int P = num_threads();
+        _pool.for_each_thread( [&](unsigned int t){
+            for (std::size_t i = t; t < P && i < _islands.size(); i += P) evolve(i);
+        } );
+        collect();
+        return true;
+    }
+
+    virtual void run(const budget_t& budget){
+        using clock = std::chrono::steady_clock;
+        const auto start = clock::now();
+        const unsigned int P = num_threads();
+        std::atomic<bool> stop{false};
+
+        reset();
+        _pool.for_each_thread( [&](unsigned int t){
+            if ( t >= P ) return;
+            try{
+                for (std::size_t i = t; i < _islands.size(); i += P) init_island(i);
+                while ( !stop.load(std::memory_order_relaxed) ){
+                    for (std::size_t i = t; i < _islands.size(); i += P){
+                        evolve(i);
+                        // another island may raise _last_improvement past the evaluations read here
+                        const std::uint64_t last        = _last_improvement.load(std::memory_order_relaxed);
+                        const std::uint64_t evaluations = _evaluations.load(std::memory_order_relaxed);
+                        if ( evaluations >= budget.evaluations ||
+                             ( evaluations > last ? evaluations - last : 0 ) >= budget.stagnation ||
+                             std::chrono::duration<double>( clock::now() - start ).count() >= budget.seconds ){
+                            stop.store(true, std::memory_order_relaxed);
+                            break;
+                        }
+                    }
+                }
+            }
+            catch (...){
+                stop.store(true, std::memory_order_relaxed);
+                throw;
+            }
+        } );
+        collect();
+        this->_stats.seconds = std::chrono::duration<double>( clock::now() - start ).count();
+    }
+
+    virtual const solution_t& best() const {
+        const island_t& is = _islands[_best_island];
+        return is.population[is.best];
+    }
+
+    virtual objective_value_t best_value() const {
+        const island_t& is = _islands[_best_island];
+        return is.values[is.best];
+    }
+    /**
+     * @brief The number of islands.
+     */
+    std::size_t num_islands() const noexcept { return _islands.size(); }
+    /**
+     * @brief The population of island i and the values of its solutions.
+     */
+    const std::vector<solution_t>&        population(std::size_t i) const noexcept { return _islands[i].population; }
+    const std::vector<objective_value_t>& values(std::size_t i) const noexcept { return _islands[i].values; }
+    /**
+     * @brief The number of migrants island i sent, received and took in (those better than its worst solution).
+     */
+    std::uint64_t sent(std::size_t i) const noexcept { return _islands[i].sent; }
+    std::uint64_t received(std::size_t i) const noexcept { return _islands[i].received; }
+    std::uint64_t accepted(std::size_t i) const noexcept { return _islands[i].accepted; }
+
+private:
+
+    struct migrant_t{
+        solution_t        solution;
+        objective_value_t value = objective_value_t();
+    };
+
+    using queue_type = SpscQueue<migrant_t>;
+
+    // everything an island writes while it runs, on cache lines of its own
+    struct alignas(64) island_t{
+        RandomXoshiro256               rng;
+        operators_t                    ops{};
+        std::vector<solution_t>        population;
+        std::vector<objective_value_t> values;
+        std::vector<solution_t>        children;
+        std::vector<objective_value_t> child_values;
+        migrant_t                      migrant;
+        std::vector<queue_type*>       out;
+        std::vector<queue_type*>       in;
+        std::size_t                    best  = 0;
+        std::size_t                    worst = 0;
+        std::uint64_t                  generation = 0;
+        std::uint64_t                  replacements = 0;
+        std::uint64_t                  sent = 0;
+        std::uint64_t                  received = 0;
+        std::uint64_t                  accepted = 0;
+    };
+
+    // installs the engine of an island as the engine of the thread, for the lifetime of the object
+    class engine_scope : public NonCopyable
+    {
+    public:
+        explicit engine_scope(RandomEngine& engine) noexcept : _previous( SetThreadRandomEngine(&engine) ) {}
+        ~engine_scope(){ SetThreadRandomEngine(_previous); }
+    private:
+        RandomEngine* _previous;
+    };
+
+    unsigned int num_threads() const noexcept {
+        return std::min( _pool.size(), static_cast<unsigned int>( _islands.size() ) );
+    }
+
+    // one queue per directed edge of the topology
+    void connect(){
+        const std::size_t K = _islands.size();
+        auto edge = [this](std::size_t from, std::size_t to){
+            if ( from == to ) return;
+            for (queue_type* q : _islands[from].out) for (queue_type* r : _islands[to].in) if ( q == r ) return;
+            _queues.emplace_back( new queue_type(_config.queue_capacity) );
+            _islands[from].out.push_back( _queues.back().get() );
+            _islands[to].in.push_back( _queues.back().get() );
+        };
+        switch ( _config.topology ){
+        case topology_t::ring:
+            for (std::size_t i = 0; i < K; ++i) edge( i, ( i + 1 ) % K );
+            break;
+        case topology_t::torus:{
+            // the most square grid: rows is the largest divisor of K not above sqrt(K)
+            std::size_t rows = static_cast<std::size_t>( std::sqrt( double(K) ) );
+            while ( K % rows ) --rows;
+            const std::size_t columns = K / rows;
+            for (std::size_t i = 0; i < K; ++i){
+                const std::size_t r = i / columns, c = i % columns;
+                edge( i, r * columns + ( c + 1 ) % columns );
+                edge( i, r * columns + ( c + columns - 1 ) % columns );
+                edge( i, ( ( r + 1 ) % rows ) * columns + c );
+                edge( i, ( ( r + rows - 1 ) % rows ) * columns + c );
+            }
+            break;
+        }
+        case topology_t::random:
+            for (std::size_t i = 0; i < K; ++i) for (std::size_t j = 0; j < K; ++j) edge(i, j);
+            break;
+        }
+    }
+
+    void reset(){
+        this->_stats = search_stats_t();
+        _best_island = 0;
+        _evaluations.store(0);
+        _last_improvement.store(0);
+        for (std::size_t i = 0; i < _islands.size(); ++i){
+            island_t& is = _islands[i];
+            _streams.seed( is.rng, static_cast<unsigned>(i) );
+            is.generation = is.replacements = is.sent = is.received = is.accepted = 0;
+            migrant_t m;
+            for (queue_type* q : is.in) while ( q->try_pop(m) );
+        }
+    }
+
+    void init_island(std::size_t i){
+        island_t&    is = _islands[i];
+        engine_scope scope(is.rng);
+        for (auto& s : is.population) s = ( *is.ops.create )();
+        is.ops.objective->evaluate( is.population.data(), is.values.data(), is.population.size() );
+        is.best = is.worst = 0;
+        for (std::size_t k = 1; k < is.values.size(); ++k){
+            if ( better( is.values[k], is.values[is.best] ) )  is.best = k;
+            if ( better( is.values[is.worst], is.values[k] ) ) is.worst = k;
+        }
+        _evaluations.fetch_add( is.population.size(), std::memory_order_relaxed );
+    }
+
+    // one generation of island i, and its migration when due
+    void evolve(std::size_t i){
+        island_t&         is = _islands[i];
+        engine_scope      scope(is.rng);
+        const std::size_t n  = is.population.size();
+
+        for (std::size_t k = 0; k < is.children.size(); ++k){
+            const std::size_t parent = is.ops.select->select( is.values.data(), n );
+            is.children[k] = ( *is.ops.variation )( is.population[parent] );
+        }
+        is.ops.objective->evaluate( is.children.data(), is.child_values.data(), is.children.size() );
+
+        bool improved = false;
+        for (std::size_t k = 0; k < is.children.size(); ++k) improved |= insert( is, is.children[k], is.child_values[k] );
+        ++is.generation;
+        if ( is.generation % _config.interval == 0 ) improved |= migrate(is);
+
+        const std::uint64_t evaluations = _evaluations.fetch_add( is.children.size(), std::memory_order_relaxed ) + is.children.size();
+        if ( improved ){
+            std::uint64_t last = _last_improvement.load(std::memory_order_relaxed);
+            while ( last < evaluations && !_last_improvement.compare_exchange_weak(last, evaluations, std::memory_order_relaxed) );
+        }
+    }
+
+    // swaps s into the population in place of the worst solution if it is better; true if the best improved
+    bool insert(island_t& is, solution_t& s, objective_value_t value){
+        if ( !better( value, is.values[is.worst] ) ) return false;
+        // compared before the swap: the worst solution may also be the best one (equal values, a population of 1)
+        const bool improved = better( value, is.values[is.best] );
+        using std::swap;
+        swap( is.population[is.worst], s );
+        is.values[is.worst] = value;
+        ++is.replacements;
+
+        if ( improved ) is.best = is.worst;
+        for (std::size_t k = 0; k < is.values.size(); ++k) if ( better( is.values[is.worst], is.values[k] ) ) is.worst = k;
+        return improved;
+    }
+
+    bool migrate(island_t& is){
+        const std::size_t n = is.population.size();
+        if ( !is.out.empty() && _config.migrants ){
+            auto send = [&](queue_type* q){
+                for (unsigned int m = 0; m < _config.migrants; ++m){
+                    const std::size_t k = m ? is.ops.select->select( is.values.data(), n ) : is.best;
+                    is.migrant.solution = is.population[k];
+                    is.migrant.value    = is.values[k];
+                    if ( !q->try_push(is.migrant) ) break;
+                    ++is.sent;
+                }
+            };
+            if ( _config.topology == topology_t::random ){
+                send( is.out[ Random().uniform_int_between( 0, static_cast<unsigned int>( is.out.size() - 1 ) ) ] );
+            }
+            else{
+                for (queue_type* q : is.out) send(q);
+            }
+        }
+
+        bool improved = false;
+        for (queue_type* q : is.in){
+            while ( q->try_pop(is.migrant) ){
+                ++is.received;
+                const std::uint64_t replacements = is.replacements;
+                improved |= insert( is, is.migrant.solution, is.migrant.value );
+                is.accepted += is.replacements - replacements;
+            }
+        }
+        return improved;
+    }
+
+    // the counters and the best island, once the islands have stopped
+    void collect(){
+        this->_stats.evaluations      = _evaluations.load();
+        this->_stats.last_improvement = _last_improvement.load();
+        this->_stats.moves            = 0;
+        for (std::size_t i = 0; i < _islands.size(); ++i){
+            const island_t& is = _islands[i];
+            this->_stats.moves += is.replacements;
+            if ( better( is.values[is.best], _islands[_best_island].values[ _islands[_best_island].best ] ) ) _best_island = i;
+        }
+    }
+
+    island_config_t                                     _config;
+    ThreadPool&                                         _pool;
+    RandomStreams                                       _streams;
+    std::vector< island_t, AlignedAllocator<island_t> > _islands;
+    std::vector< std::unique_ptr<queue_type> >          _queues;
+    std::size_t                                         _best_island = 0;
+    std::atomic<std::uint64_t>                          _evaluations{0};
+    std::atomic<std::uint64_t>                          _last_improvement{0};
+};
+
+}
+}
+
+#endif // ISLANDMODEL_HPP
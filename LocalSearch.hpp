@@ -6,9 +6,179 @@
 #ifndef LOCALSEARCH_HPP
 #define LOCALSEARCH_HPP
 
+#include "Algorithm.hpp"
+#include "ComparissonOperator.hpp"
+#include "CreateOperator.hpp"
+#include "NonCopyable.hpp"
+#include "ObjectiveFunction.hpp"
+#include "Random.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
 namespace onion{
 namespace algorithms{
 
+/**
+ * @brief How a step of a local search chooses among the improving neighbours of its sample.
+ */
+enum class improvement_t{
+    first,  ///< the first improving neighbour drawn
+    best,   ///< the best neighbour of the sample, if it improves
+    random  ///< an improving neighbour of the sample, drawn uniformly
+};
+
+/** @class LocalSearch
+ *  @brief Local search over a neighbourhood given by its delta components.
+ *  @param solution_t the type used to represent a solution to a problem.
+ *  @param parameter_t the type of the transformation parameters.
+ *  @param objective_value_t the type used to represent the value of a solution.
+ *  @param parameter_op_t a concrete ParameterOperator< solution_t, parameter_t >: draws the neighbours.
+ *  @param delta_t a concrete DeltaObjective< solution_t, parameter_t, objective_value_t >: evaluates them.
+ *  @param move_t a concrete MoveOperator< solution_t, parameter_t, ... >: applies the chosen one, in place.
+ *  @param better the comparisson that defines an improvement: Less to minimize, Greater to maximize.
+ *
+ *  Each step draws up to `sample` parameters, evaluates their delta and applies one improving move,
+ *  chosen by the improvement_t policy. The solution is changed in place: no solution is copied or
+ *  created while searching.
+ *
+ *  The components are called with qualified names (`delta_t::operator()`), which binds the calls at compile
+ *  time and makes no heap allocation. The template parameters must therefore be the concrete classes, not
+ *  the abstract interfaces. The random draws are bound the same way only when the parameter operator is
+ *  given a concrete engine (`RandomTwoOpt< path_type, RandomXoshiro256 >(num_cities, &engine)`): the
+ *  inner loop then makes no virtual call. Drawing from Random() costs a virtual call per draw, and so
+ *  does the random policy, which calls Random() once per improving neighbour.
+ *
+ *  The budget is checked between steps. The clock is read before the first step, then every 256
+ *  evaluations or so.
+ *
+ *      using namespace onion::cops::tsp::array;
+ *      RandomXoshiro256                                  engine;
+ *      RandomTwoOpt< path_type, RandomXoshiro256 >       neighbours(num_cities, &engine);
+ *      DeltaTwoOpt< problem_data_t, path_type >          delta(data);
+ *      TwoOptMove< path_type >                           move;
+ *      LocalSearch< path_type, two_opt_t, cost_t<problem_data_t>,
+ *                   RandomTwoOpt< path_type, RandomXoshiro256 >,
+ *                   DeltaTwoOpt< problem_data_t, path_type >,
+ *                   TwoOptMove< path_type > > search(neighbours, delta, move, improvement_t::best, 64);
+ *
+ *      budget_t budget;
+ *      budget.seconds = 1;
+ *      auto value = search.improve(path, TourLength< problem_data_t, path_type >::length(data, path), budget);
+ */
+template< typename solution_t, typename parameter_t, typename objective_value_t,
+          typename parameter_op_t, typename delta_t, typename move_t,
+          ComparissonOperator<objective_value_t> better = Less<objective_value_t> >
+class LocalSearch : public NonCopyable
+{
+    static_assert( !std::is_abstract<parameter_op_t>::value && !std::is_abstract<delta_t>::value &&
+                   !std::is_abstract<move_t>::value, "LocalSearch needs the concrete component classes" );
+
+public:
+    /**
+     * @brief Class constructor.
+     * @param [in] parameters draws the neighbours.
+     * @param [in] delta evaluates the neighbours.
+     * @param [in] move applies the chosen neighbour.
+     * @param [in] mode the improvement policy.
+     * @param [in] sample the number of neighbours drawn per step, at least 1.
+     *
+     * The components must outlive the search.
+     */
+    LocalSearch(parameter_op_t& parameters, delta_t& delta, move_t& move,
+                improvement_t mode = improvement_t::first, std::size_t sample = 1):
+        _parameters(parameters),
+        _delta(delta),
+        _move(move),
+        _mode(mode),
+        _sample( sample ? sample : 1 ){
+    }
+    /**
+     * @brief Improves a solution in place until the budget is exhausted.
+     * @param [in,out] s the solution.
+     * @param [in] value the value of s.
+     * @param [in] budget the stopping criteria.
+     * @return The value of the improved solution.
+     */
+    objective_value_t improve(solution_t& s, objective_value_t value, const budget_t& budget){
+        using clock = std::chrono::steady_clock;
+        const auto start = clock::now();
+        const objective_value_t zero = objective_value_t();
+
+        _stats = search_stats_t();
+        std::uint64_t next_clock = 0;
+
+        while ( _stats.evaluations < budget.evaluations && _stats.evaluations - _stats.last_improvement < budget.stagnation ){
+            if ( _stats.evaluations >= next_clock ){
+                next_clock = _stats.evaluations + 256;
+                if ( std::chrono::duration<double>( clock::now() - start ).count() >= budget.seconds ) break;
+            }
+
+            parameter_t       chosen{};
+            objective_value_t chosen_delta = zero;
+            std::uint64_t     improving = 0;
+
+            for (std::size_t k = 0; k < _sample && _stats.evaluations < budget.evaluations; ++k){
+                const parameter_t       p = _parameters.parameter_op_t::operator()();
+                const objective_value_t d = _delta.delta_t::operator()(s, p);
+                ++_stats.evaluations;
+                if ( !better(d, zero) ) continue;
+
+                ++improving;
+                if ( _mode == improvement_t::first ){
+                    chosen = p;  chosen_delta = d;
+                    break;
+                }
+                if ( _mode == improvement_t::best ? ( improving == 1 || better(d, chosen_delta) )
+                                                  : Random().uniform_int_between(1, unsigned(improving)) == 1 ){
+                    chosen = p;  chosen_delta = d;
+                }
+            }
+
+            if ( improving ){
+                _move.move_t::apply(s, chosen);
+                value += chosen_delta;
+                ++_stats.moves;
+                _stats.last_improvement = _stats.evaluations;
+            }
+        }
+        _stats.seconds = std::chrono::duration<double>( clock::now() - start ).count();
+        return value;
+    }
+    /**
+     * @brief Creates a solution and improves it until the budget is exhausted.
+     * @param [in] create creates the starting solution.
+     * @param [in] objective evaluates the starting solution.
+     * @param [in] budget the stopping criteria.
+     * @return The improved solution. Its value is returned by value().
+     */
+    solution_t run(CreateOperator<solution_t>& create, ObjectiveFunction<solution_t, objective_value_t>& objective,
+                   const budget_t& budget){
+        solution_t s = create();
+        _value = improve( s, objective(s), budget );
+        return s;
+    }
+    /**
+     * @brief The value of the solution returned by the last run().
+     */
+    objective_value_t value() const noexcept { return _value; }
+    /**
+     * @brief The counters of the last search.
+     */
+    const search_stats_t& stats() const noexcept { return _stats; }
+
+private:
+
+    parameter_op_t&   _parameters;
+    delta_t&          _delta;
+    move_t&           _move;
+    improvement_t     _mode;
+    std::size_t       _sample;
+    objective_value_t _value = objective_value_t();
+    search_stats_t    _stats;
+};
+
 }
 }
 #endif
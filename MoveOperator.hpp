@@ -0,0 +1,133 @@
+/** @file onion/MoveOperator.hpp
+ *  @brief This header introduces the MoveOperator class interface: in-place transformations with undo.
+ *  <hr>
+ *  @copyright 2022 André Ladeira / Onion Framework.
+ */
+#ifndef MOVEOPERATOR_HPP
+#define MOVEOPERATOR_HPP
+
+#include "NonCopyable.hpp"
+#include "ComponentID.hpp"
+#include "PerturbationOperator.hpp"
+
+namespace onion{
+
+/** @class MoveOperator
+ *  @brief Abstract Data Type that defines the MoveOperator component.
+ *  @param solution_t the type used to represent a solution to a problem.
+ *  @param parameter_t the type of the transformation parameters, usually created by a ParameterOperator.
+ *  @param undo_t the type of the token that reverts a transformation. By default, the parameter type.
+ *
+ *  A PerturbationOperator returns new solutions by value. That is the simplest protocol,
+ *  but every candidate costs a full copy of the solution: for a tour with 10 000 cities, a 2-opt move
+ *  that changes a handful of positions moves 40 KB of memory.
+ *
+ *  A MoveOperator applies the transformation <b>τ(S,P<sub>i</sub>)</b> to the solution itself:
+ *
+ *  - apply(S,P) transforms **S** in place and returns an *undo token*.
+ *  - undo(S,U) reverts the transformation, given the token returned by apply.
+ *
+ *  An algorithm that evaluates candidates with a DeltaObjective only needs to apply the moves it accepts.
+ *  An algorithm that needs the complete candidate (to call an ObjectiveFunction, for example) applies the move,
+ *  evaluates the solution and undoes the move if it is rejected. Neither needs a copy.
+ *
+ *  For most transformations, the undo token is the parameter itself (a reversal or a swap are their own
+ *  inverses) or a parameter that is trivially derived from it (the inverse of an insertion).
+ *  Transformations that lose information, like a random reinitialization, can use the old values as token.
+ *
+ *  <h3>Opting in</h3>
+ *
+ *  MoveOperator is independent from PerturbationOperator. Since the component interfaces inherit ComponentID
+ *  virtually, an existing operator can implement both and keep its copy-returning interface:
+ *
+ *      class Swap : public PerturbationOperator< path_t, path_t >,
+ *                   public MoveOperator< path_t, swap_t >{ ... };
+ *
+ *  Operators that only implement the copy-returning interface can still be used where a MoveOperator is
+ *  required through the CopyMove adapter, which is the (expensive) fallback.
+ *
+ *  @note
+ *  MoveOperator is an <a href="./md__glossary.html#abstract_data_type">Abstract Data Type</a>.
+ *  It means it provides no functionality and can't be instantiated.
+ *  Actual functionality will be defined later by concrete implementions in derived classes.
+ *
+ */
+template< typename solution_t, typename parameter_t, typename undo_t = parameter_t >
+class MoveOperator : public NonCopyable, public virtual ComponentID
+{
+public:
+    /**
+     * @brief Type of the undo token.
+     */
+    using undo_type = undo_t;
+    /**
+     * @brief Class destructor.
+     */
+    virtual ~MoveOperator() = default;
+    /**
+     * @brief Transforms a solution in place.
+     * @param S the solution to be transformed. It is valid before and after the call.
+     * @param P the transformation parameter. It must be valid for S.
+     * @return A token that reverts the transformation when passed to undo().
+     */
+    virtual undo_t apply(solution_t& S, const parameter_t& P) = 0;
+    /**
+     * @brief Reverts a transformation.
+     * @param S the solution. It must be in the state left by the apply() call that returned U.
+     * @param U the undo token returned by apply().
+     */
+    virtual void undo(solution_t& S, const undo_t& U) = 0;
+};
+
+/**
+ * @brief Parameter type of the moves that do not take any parameter.
+ */
+struct no_parameter_t{};
+
+/** @class CopyMove
+ *  @brief Adapts a copy-returning PerturbationOperator to the MoveOperator protocol.
+ *  @param solution_t the type used to represent a solution to a problem.
+ *
+ *  The perturbation must return a single solution. The undo token is a copy of the solution before the
+ *  transformation, so this adapter costs two copies per move. It exists so that operators which have not
+ *  opted in to the in-place protocol keep working with algorithms that use it.
+ */
+template< typename solution_t >
+class CopyMove final : public MoveOperator< solution_t, no_parameter_t, solution_t >
+{
+public:
+    /**
+     * @brief Class constructor.
+     * @param perturbation the adapted operator. It must outlive the adapter.
+     */
+    CopyMove(PerturbationOperator< solution_t, solution_t >& perturbation):
+        ComponentID( IDBuilder()
+                    .name("CopyMove")
+                    .description("Adapts a copy-returning PerturbationOperator to the MoveOperator protocol.")
+                    .type("Move Operator")
+                    .version("v0.1.0")),
+        _perturbation(perturbation){
+    }
+    /**
+     * @brief Replaces S with a perturbed copy and returns the previous solution.
+     */
+    virtual solution_t apply(solution_t& S, const no_parameter_t&){
+        solution_t previous = S;
+        S = _perturbation(previous);
+        return previous;
+    }
+    /**
+     * @brief Restores the previous solution.
+     */
+    virtual void undo(solution_t& S, const solution_t& U){
+        S = U;
+    }
+
+private:
+
+    PerturbationOperator< solution_t, solution_t >& _perturbation;
+};
+
+}
+
+#endif // MOVEOPERATOR_HPP
@@ -0,0 +1,233 @@
+/** @file onion/MultiStart.hpp
+ *  @brief This header introduces the MultiStart runner.
+ *  <hr>
+ *  @copyright 2022 André Ladeira / Onion Framework.
+ */
+#ifndef MULTISTART_HPP
+#define MULTISTART_HPP
+
+#include "AlignedAllocator.hpp"
+#include "ComparissonOperator.hpp"
+#include "CreateOperator.hpp"
+#include "NonCopyable.hpp"
+#include "ObjectiveFunction.hpp"
+#include "RandomStreams.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace onion{
+namespace algorithms{
+
+/** @class MultiStart
+ *  @brief Runs a local search from many starting solutions, in parallel, and keeps the best result.
+ *  @param solution_t the type used to represent a solution to a problem.
+ *  @param objective_value_t the type used to represent the value of a solution. It must be usable in a
+ *         std::atomic (an arithmetic type, typically).
+ *  @param better the comparisson that defines an improvement: Less to minimize, Greater to maximize.
+ *
+ *  A restart creates a solution with a CreateOperator, evaluates it with an ObjectiveFunction and improves
+ *  it with a local search, given as a function `value = improve(s, value)` that improves s in place:
+ *
+ *      LocalSearch< ... > search(neighbours, delta, move, improvement_t::best, 64);
+ *      MultiStart< path_type, cost_type >::worker_t worker{ &create, &length,
+ *          [&](path_type& p, cost_type value){ return search.improve(p, value, budget); } };
+ *
+ *  or, for a PerturbationOperator that returns a local optimum (TwoOpt, LinKernighan):
+ *
+ *      [&](path_type& p, cost_type value){ return value + two_opt.improve(p); }
+ *
+ *  The workers run on the threads of a ThreadPool, with their own components, given per worker: the local
+ *  searches keep state, so they are rarely safe to share. A worker claims the next restart when it finishes
+ *  one, so a worker that drew short restarts simply runs more of them: restarts whose lengths vary widely
+ *  keep every thread busy until the last ones, which a static split of the restarts among the threads does not.
+ *
+ *  Each worker has:
+ *
+ *  - its own random engine, stream t of a RandomStreams, installed as the engine of its thread (a
+ *    ThreadRandomContext) for the whole run;
+ *  - the solution of its current restart, the one returned by its CreateOperator (by value, so a solution
+ *    that owns memory is allocated by each restart, then moved into the worker);
+ *  - its own buffer for the best solution it found, reused by every restart: copying an improvement into
+ *    it reuses its memory.
+ *
+ *  The value of the best solution found by all workers is a single std::atomic, lowered (or raised) with a
+ *  compare-and-swap loop: no lock is taken. A worker copies a solution into its best buffer only when it
+ *  improves that shared value, so the best solution of the run is in the buffer of the last worker that
+ *  improved it. The run stops early when the shared value reaches the target, or when the time is up;
+ *  both are checked between restarts, and a long restart may poll cancelled() to stop sooner.
+ *
+ *  Which worker runs which restart depends on timing, so a run is not reproducible with more than one worker.
+ */
+template< typename solution_t, typename objective_value_t,
+          ComparissonOperator<objective_value_t> better = Less<objective_value_t> >
+class MultiStart : public NonCopyable
+{
+public:
+    /**
+     * @brief The local search of a restart: improves a solution in place, given its value, and returns the new value.
+     */
+    using improve_type = std::function< objective_value_t(solution_t&, objective_value_t) >;
+    /**
+     * @brief The components of a worker. Without an improve function, a restart only creates and evaluates a solution.
+     */
+    struct worker_t{
+        CreateOperator<solution_t>*                       create;
+        ObjectiveFunction<solution_t, objective_value_t>* objective;
+        improve_type                                      improve;
+    };
+    /**
+     * @brief Class constructor, for components shared by all the threads of the pool.
+     *
+     * The components are called concurrently: they must keep no state that changes with the calls.
+     */
+    MultiStart(CreateOperator<solution_t>& create, ObjectiveFunction<solution_t, objective_value_t>& objective,
+               const improve_type& improve, ThreadPool& pool, RandomEngine::int_t seed = 0):
+        MultiStart( std::vector<worker_t>( pool.size(), worker_t{ &create, &objective, improve } ), pool, seed ){
+    }
+    /**
+     * @brief Class constructor.
+     * @param [in] workers the components of each worker. There are min(workers.size(), pool.size()) workers.
+     * @param [in] pool the threads that run the workers.
+     * @param [in] seed the master seed of the random streams. 0 draws a seed from std::random_device.
+     *
+     * The components and the pool must outlive the runner.
+     */
+    MultiStart(const std::vector<worker_t>& workers, ThreadPool& pool, RandomEngine::int_t seed = 0):
+        _pool(pool),
+        _streams(seed),
+        _workers( std::max<std::size_t>( 1, std::min<std::size_t>( workers.size(), pool.size() ) ) ){
+        for (std::size_t t = 0; t < _workers.size(); ++t) _workers[t].ops = workers[ t % workers.size() ];
+    }
+    /**
+     * @brief Stops the next runs as soon as a solution as good as value is found.
+     */
+    void target(objective_value_t value) noexcept {
+        _target     = value;
+        _has_target = true;
+    }
+    /**
+     * @brief Runs the restarts.
+     * @param [in] restarts the number of restarts.
+     * @param [in] seconds the wall-clock time after which no restart is started.
+     * @return The value of the best solution found.
+     */
+    objective_value_t run(std::size_t restarts, double seconds = std::numeric_limits<double>::infinity()){
+        using clock = std::chrono::steady_clock;
+        const auto start = clock::now();
+        const unsigned int P = static_cast<unsigned int>( _workers.size() );
+
+        _incumbent.store( worst_value() );
+        _next.store(0);
+        _stop.store(false);
+        for (auto& w : _workers){
+            w.restarts = 0;
+            w.has_best = false;
+        }
+
+        _pool.for_each_thread( [&](unsigned int t){
+            if ( t >= P ) return;
+            worker_state&       w = _workers[t];
+            ThreadRandomContext context(_streams, t);
+            try{
+                while ( !_stop.load(std::memory_order_relaxed) && _next.fetch_add(1, std::memory_order_relaxed) < restarts ){
+                    w.current = ( *w.ops.create )();
+                    objective_value_t value = ( *w.ops.objective )(w.current);
+                    if ( w.ops.improve ) value = w.ops.improve(w.current, value);
+                    ++w.restarts;
+
+                    if ( offer(value) ){
+                        w.best       = w.current;
+                        w.best_value = value;
+                        w.has_best   = true;
+                    }
+                    if ( ( _has_target && !better( _target, _incumbent.load(std::memory_order_relaxed) ) ) ||
+                         std::chrono::duration<double>( clock::now() - start ).count() >= seconds ){
+                        _stop.store(true, std::memory_order_relaxed);
+                    }
+                }
+            }
+            catch (...){
+                _stop.store(true, std::memory_order_relaxed);
+                throw;
+            }
+        } );
+
+        _restarts = 0;
+        _best_worker = 0;
+        for (std::size_t t = 0; t < _workers.size(); ++t){
+            _restarts += _workers[t].restarts;
+            if ( _workers[t].has_best && ( !_workers[_best_worker].has_best ||
+                                           better( _workers[t].best_value, _workers[_best_worker].best_value ) ) ) _best_worker = t;
+        }
+        _seconds = std::chrono::duration<double>( clock::now() - start ).count();
+        return best_value();
+    }
+    /**
+     * @brief The best solution of the last run. Only valid if a restart was completed.
+     */
+    const solution_t& best() const noexcept { return _workers[_best_worker].best; }
+    /**
+     * @brief The value of the best solution of the last run.
+     */
+    objective_value_t best_value() const noexcept { return _incumbent.load(); }
+    /**
+     * @brief The number of restarts completed by the last run, and its duration.
+     */
+    std::size_t restarts() const noexcept { return _restarts; }
+    double      seconds() const noexcept { return _seconds; }
+    /**
+     * @brief True once the running run has reached its target, its time limit or failed: no restart will start.
+     */
+    bool cancelled() const noexcept { return _stop.load(std::memory_order_relaxed); }
+
+private:
+
+    // what a worker writes, on cache lines of its own
+    struct alignas(64) worker_state{
+        worker_t          ops{};
+        solution_t        current;
+        solution_t        best;
+        objective_value_t best_value = objective_value_t();
+        bool              has_best = false;
+        std::size_t       restarts = 0;
+    };
+
+    static objective_value_t worst_value() noexcept {
+        using limits = std::numeric_limits<objective_value_t>;
+        return better( objective_value_t(0), objective_value_t(1) ) ? limits::max() : limits::lowest();
+    }
+
+    // lowers (raises) the shared value to value if it is better; true if it did
+    bool offer(objective_value_t value) noexcept {
+        objective_value_t current = _incumbent.load(std::memory_order_relaxed);
+        while ( better(value, current) ){
+            if ( _incumbent.compare_exchange_weak(current, value, std::memory_order_relaxed) ) return true;
+        }
+        return false;
+    }
+
+    ThreadPool&                                                 _pool;
+    RandomStreams                                               _streams;
+    std::vector< worker_state, AlignedAllocator<worker_state> > _workers;
+    objective_value_t                                           _target     = objective_value_t();
+    bool                                                        _has_target = false;
+
+    std::atomic<objective_value_t>                              _incumbent{ objective_value_t() };
+    std::atomic<std::size_t>                                    _next{0};
+    std::atomic<bool>                                           _stop{false};
+
+    std::size_t                                                 _restarts    = 0;
+    std::size_t                                                 _best_worker = 0;
+    double                                                      _seconds     = 0;
+};
+
+}
+}
+
+#endif // MULTISTART_HPP
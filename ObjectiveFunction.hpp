@@ -8,6 +8,7 @@
 
 #include "NonCopyable.hpp"
 #include "ComponentID.hpp"
+#include <cstddef>
 
 namespace onion{
 
@@ -24,6 +25,11 @@ namespace onion{
  *  It is the objective function that tells the algorithm if a solution **A**
  *  is better or worse than some other alternative **B**.
  *
+ *  Algorithms that work on populations evaluate many solutions at once through evaluate().
+ *  By default it calls operator() on each solution. Problems override it with kernels that
+ *  evaluate several solutions per call (vectorized over solutions, for example), and
+ *  ParallelObjective spreads the evaluations over the threads of a ThreadPool.
+ *
  *  @note
  *  ObjectiveFunction is an <a href="./md__glossary.html#abstract_data_type">Abstract Data Type</a>.
  *  It means it provides no functionality and can't be instantiated.
@@ -32,7 +38,7 @@ namespace onion{
  *
  */
 template< typename solution_t, typename objective_value_t>
-class ObjectiveFunction : public NonCopyable, public ComponentID
+class ObjectiveFunction : public NonCopyable, public virtual ComponentID
 {
 public:
 
@@ -46,6 +52,15 @@ public:
      * @return A (possibly unitary) set of values that rank the solutions relatives to each other.
      */
     virtual objective_value_t operator()(const solution_t& s) = 0;
+    /**
+     * @brief Assigns a value to each solution of a set.
+     * @param [in] solutions the n solutions to be evaluated.
+     * @param [out] values the n values: values[i] is the value of solutions[i].
+     * @param [in] n the number of solutions.
+     */
+    virtual void evaluate(const solution_t* solutions, objective_value_t* values, std::size_t n){
+        for (std::size_t i = 0; i < n; ++i) values[i] = (*this)(solutions[i]);
+    }
 };
 
 }
@@ -0,0 +1,66 @@
+/** @file onion/ParallelObjective.hpp
+ *  @brief Contains the definition of the ParallelObjective component.
+ *  <hr>
+ *  @copyright 2022 André Ladeira / Onion Framework.
+ */
+#ifndef PARALLELOBJECTIVE_HPP
+#define PARALLELOBJECTIVE_HPP
+
+#include "ObjectiveFunction.hpp"
+#include "ThreadPool.hpp"
+#include <cstddef>
+
+namespace onion{
+
+/** @class ParallelObjective
+ *  @brief ObjectiveFunction that evaluates sets of solutions on the threads of a ThreadPool.
+ *  @param solution_t the type used to represent a solution to a problem.
+ *  @param objective_value_t the type used to represent the value of a solution.
+ *
+ *  ParallelObjective wraps another ObjectiveFunction. Single solutions are evaluated by the
+ *  wrapped function, on the calling thread. evaluate() splits the set of solutions into blocks of
+ *  consecutive solutions and passes each block to the evaluate() of the wrapped function, from the
+ *  threads of the pool. There are about 16 blocks per thread, each one large enough for a vectorized
+ *  evaluate() to run at full width when the set is large.
+ *
+ *  The wrapped function is called concurrently: its evaluate() must be safe to call from several threads
+ *  on disjoint blocks. Both the wrapped function and the pool must outlive the ParallelObjective.
+ */
+template< typename solution_t, typename objective_value_t >
+class ParallelObjective : public ObjectiveFunction< solution_t, objective_value_t >
+{
+public:
+    /**
+     * @brief Class constructor.
+     * @param [in] function the wrapped objective function.
+     * @param [in] pool the threads that evaluate the sets of solutions.
+     */
+    ParallelObjective(ObjectiveFunction< solution_t, objective_value_t >& function, ThreadPool& pool):
+        ComponentID( IDBuilder()
+                    .name("ParallelObjective")
+                    .description("Evaluates sets of solutions on the threads of a pool.")
+                    .type("Objective Function")
+                    .version("v0.1.0")),
+        _function(function),
+        _pool(pool){
+    }
+
+    virtual objective_value_t operator()(const solution_t& s){
+        return _function(s);
+    }
+
+    virtual void evaluate(const solution_t* solutions, objective_value_t* values, std::size_t n){
+        _pool.parallel_for( n, [&](std::size_t first, std::size_t last){
+            _function.evaluate( solutions + first, values + first, last - first );
+        } );
+    }
+
+private:
+
+    ObjectiveFunction< solution_t, objective_value_t >& _function;
+    ThreadPool&                                         _pool;
+};
+
+}
+
+#endif // PARALLELOBJECTIVE_HPP
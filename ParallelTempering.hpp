@@ -0,0 +1,249 @@
+/** @file onion/ParallelTempering.hpp
+ *  @brief This header introduces the Parallel Tempering (replica exchange) algorithm.
+ *  <hr>
+ *  @copyright 2022 André Ladeira / Onion Framework.
+ */
+#ifndef PARALLELTEMPERING_HPP
+#define PARALLELTEMPERING_HPP
+
+#include "AlignedAllocator.hpp"
+#include "Algorithm.hpp"
+#include "RandomStreams.hpp"
+#include "SimulatedAnnealing.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace onion{
+namespace algorithms{
+
+/** @class ParallelTempering
+ *  @brief Replica exchange: annealing chains at fixed temperatures that exchange their temperatures.
+ *  @param solution_t the type used to represent a solution to a problem.
+ *  @param parameter_t the type of the transformation parameters.
+ *  @param objective_value_t the type used to represent the value of a solution.
+ *  @param parameter_op_t a concrete ParameterOperator< solution_t, parameter_t >: draws the neighbours.
+ *  @param delta_t a concrete DeltaObjective< solution_t, parameter_t, objective_value_t >: evaluates them.
+ *  @param move_t a concrete MoveOperator< solution_t, parameter_t, ... >: applies the accepted ones, in place.
+ *  @param better the comparisson that defines an improvement: Less to minimize, Greater to maximize.
+ *
+ *  K replicas, each one a SimulatedAnnealing chain, hold the temperatures T<sub>0</sub> < ... < T<sub>K-1</sub>
+ *  of a ladder. A round is made of:
+ *
+ *  1. every replica performs `moves_per_exchange` Metropolis moves at its temperature (SimulatedAnnealing::anneal),
+ *     in parallel: replica r runs on thread r mod P of the pool, P = min(pool size, K);
+ *  2. the replicas at neighbouring temperatures k and k + 1 (k even on even rounds, odd on odd rounds)
+ *     exchange their temperatures with probability min( 1, exp( (1/T<sub>k</sub> - 1/T<sub>k+1</sub>)
+ *     (E<sub>k</sub> - E<sub>k+1</sub>) ) ), E being the value to minimize.
+ *
+ *  The replicas exchange temperatures, not solutions: no solution is copied. The threads stay in a single
+ *  ThreadPool::for_each_thread() call for the whole run, and meet at a SpinBarrier twice per round: after the
+ *  moves, when thread 0 performs the exchanges and checks the budget, and after the exchanges. No lock is taken.
+ *
+ *  Each replica draws its random numbers from its own engine, stream r of a RandomStreams, installed as the
+ *  engine of the thread that runs it: a run is reproducible for a given seed, whatever the number of threads.
+ *  The exchanges use stream K.
+ *
+ *  The components are shared by the replicas and called concurrently: the ParameterOperator, DeltaObjective
+ *  and MoveOperator must not keep state that changes with the calls, and none of them may throw. The create
+ *  operator and the objective function are only called by init(), on the calling thread.
+ */
+template< typename solution_t, typename parameter_t, typename objective_value_t,
+          typename parameter_op_t, typename delta_t, typename move_t,
+          ComparissonOperator<objective_value_t> better = Less<objective_value_t> >
+class ParallelTempering : public Algorithm< solution_t, objective_value_t >
+{
+public:
+    /**
+     * @brief The type of the replicas.
+     */
+    using annealing_type = SimulatedAnnealing< solution_t, parameter_t, objective_value_t,
+                                               parameter_op_t, delta_t, move_t, better >;
+    /**
+     * @brief Class constructor.
+     * @param [in] create creates the starting solution of each replica.
+     * @param [in] objective evaluates the starting solutions.
+     * @param [in] parameters draws the neighbours.
+     * @param [in] delta evaluates the neighbours.
+     * @param [in] move applies the accepted neighbours.
+     * @param [in] temperatures the ladder, in increasing order: one replica per temperature, at least 2.
+     * @param [in] moves_per_exchange the number of moves of each replica per round.
+     * @param [in] pool the threads that run the replicas.
+     * @param [in] seed the master seed of the random streams. 0 draws a seed from std::random_device.
+     *
+     * The components and the pool must outlive the algorithm.
+     */
+    ParallelTempering(CreateOperator<solution_t>& create, ObjectiveFunction<solution_t, objective_value_t>& objective,
+                      parameter_op_t& parameters, delta_t& delta, move_t& move,
+                      const std::vector<double>& temperatures, std::uint64_t moves_per_exchange,
+                      ThreadPool& pool, RandomEngine::int_t seed = 0):
+        ComponentID( IDBuilder()
+                    .name("ParallelTempering")
+                    .description("Replica exchange annealing across the threads of a pool.")
+                    .type("Algorithm")
+                    .version("v0.1.0")),
+        _temperatures(temperatures),
+        _moves_per_exchange(moves_per_exchange),
+        _pool(pool),
+        _streams(seed),
+        _engines( temperatures.size() + 1 ),
+        _replica_at( temperatures.size() ),
+        _attempts( temperatures.size(), 0 ),
+        _accepted( temperatures.size(), 0 ){
+        for (double t : temperatures){
+            _replicas.emplace_back( new annealing_type( create, objective, parameters, delta, move,
+                                                        schedule_t::geometric(t, 1, moves_per_exchange, 0) ) );
+        }
+    }
+    /**
+     * @brief A ladder of K temperatures from lowest to highest, in geometric progression.
+     */
+    static std::vector<double> geometric_ladder(double lowest, double highest, unsigned int K){
+        std::vector<double> ladder(K);
+        for (unsigned int k = 0; k < K; ++k) ladder[k] = K > 1 ? lowest * std::pow( highest / lowest, double(k) / ( K - 1 ) ) : lowest;
+        return ladder;
+    }
+
+    virtual void init(){
+        this->_stats = search_stats_t();
+        _round = 0;
+        std::fill( _attempts.begin(), _attempts.end(), 0 );
+        std::fill( _accepted.begin(), _accepted.end(), 0 );
+        for (std::size_t r = 0; r < _engines.size(); ++r) _streams.seed( _engines[r].engine, static_cast<unsigned>(r) );
+
+        for (std::size_t r = 0; r < _replicas.size(); ++r){
+            RandomEngine* previous = SetThreadRandomEngine( &_engines[r].engine );
+            _replicas[r]->init();
+            SetThreadRandomEngine(previous);
+            _replica_at[r] = static_cast<unsigned int>(r);
+        }
+        _best_replica = 0;
+        update_best();
+    }
+    /**
+     * @brief Performs one round.
+     */
+    virtual bool step(){
+        rounds( budget_t(), 1, std::chrono::steady_clock::now() );
+        return true;
+    }
+
+    virtual void run(const budget_t& budget){
+        const auto start = std::chrono::steady_clock::now();
+        init();
+        rounds( budget, std::numeric_limits<std::uint64_t>::max(), start );
+        this->_stats.seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    }
+
+    virtual const solution_t& best() const { return _replicas[_best_replica]->best(); }
+
+    virtual objective_value_t best_value() const { return _replicas[_best_replica]->best_value(); }
+    /**
+     * @brief The replica at position k of the ladder, at temperature temperatures[k].
+     */
+    const annealing_type& replica(unsigned int k) const noexcept { return *_replicas[ _replica_at[k] ]; }
+    /**
+     * @brief The fraction of the exchanges between positions k and k + 1 of the ladder that were accepted.
+     *
+     * Rates far below 0.2 suggest adding temperatures between T<sub>k</sub> and T<sub>k+1</sub>.
+     */
+    double exchange_rate(unsigned int k) const noexcept { return _attempts[k] ? double(_accepted[k]) / _attempts[k] : 0; }
+
+private:
+
+    struct alignas(64) engine_slot{
+        RandomXoshiro256 engine;
+    };
+
+    template< typename time_point_t >
+    void rounds(const budget_t& budget, std::uint64_t max_rounds, time_point_t start){
+        const unsigned int K = static_cast<unsigned int>( _replicas.size() );
+        const unsigned int P = std::min( _pool.size(), K );
+        SpinBarrier        barrier(P);
+        std::atomic<bool>  stop{false};
+
+        _pool.for_each_thread( [&](unsigned int t){
+            if ( t >= P ) return;
+            for (std::uint64_t round = 0; ; ++round){
+                for (unsigned int r = t; r < K; r += P){
+                    RandomEngine* previous = SetThreadRandomEngine( &_engines[r].engine );
+                    _replicas[r]->anneal(_moves_per_exchange);
+                    SetThreadRandomEngine(previous);
+                }
+                barrier.wait();
+                if ( t == 0 ){
+                    exchange();
+                    const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+                    if ( round + 1 >= max_rounds || this->_stats.evaluations >= budget.evaluations || seconds >= budget.seconds ||
+                         this->_stats.evaluations - this->_stats.last_improvement >= budget.stagnation ) stop.store(true, std::memory_order_relaxed);
+                }
+                barrier.wait();
+                if ( stop.load(std::memory_order_relaxed) ) break;
+            }
+        } );
+    }
+
+    // exchanges at the end of a round, by thread 0
+    void exchange() noexcept {
+        const unsigned int K = static_cast<unsigned int>( _replicas.size() );
+        // the energy is the value to minimize
+        const double sign = better( objective_value_t(0), objective_value_t(1) ) ? 1.0 : -1.0;
+        RandomXoshiro256& rng = _engines[K].engine;
+
+        for (unsigned int k = static_cast<unsigned int>( _round % 2 ); k + 1 < K; k += 2){
+            const unsigned int a = _replica_at[k], b = _replica_at[k + 1];
+            const double x = ( 1 / _temperatures[k] - 1 / _temperatures[k + 1] )
+                           * sign * ( double( _replicas[a]->value() ) - double( _replicas[b]->value() ) );
+            ++_attempts[k];
+            if ( x < 0 && rng.uniform_real_01() >= fast_exp(x) ) continue;
+            ++_accepted[k];
+            _replica_at[k]     = b;
+            _replica_at[k + 1] = a;
+            _replicas[b]->temperature( _temperatures[k] );
+            _replicas[a]->temperature( _temperatures[k + 1] );
+        }
+        ++_round;
+        update_best();
+    }
+
+    void update_best() noexcept {
+        std::uint64_t evaluations = 0, moves = 0;
+        unsigned int  best = _best_replica;
+        for (unsigned int r = 0; r < _replicas.size(); ++r){
+            evaluations += _replicas[r]->stats().evaluations;
+            moves       += _replicas[r]->stats().moves;
+            if ( better( _replicas[r]->best_value(), _replicas[best]->best_value() ) ) best = r;
+        }
+        if ( best != _best_replica || better( _replicas[best]->best_value(), _best_value ) || !evaluations ){
+            _best_value = _replicas[best]->best_value();
+            this->_stats.last_improvement = evaluations;
+        }
+        _best_replica = best;
+        this->_stats.evaluations = evaluations;
+        this->_stats.moves       = moves;
+    }
+
+    std::vector<double>                                           _temperatures;
+    std::uint64_t                                                 _moves_per_exchange;
+    ThreadPool&                                                   _pool;
+    RandomStreams                                                 _streams;
+    std::vector< std::unique_ptr<annealing_type> >                _replicas;
+    std::vector< engine_slot, AlignedAllocator<engine_slot> >     _engines;
+    std::vector<unsigned int>                                     _replica_at;
+    std::vector<std::uint64_t>                                    _attempts;
+    std::vector<std::uint64_t>                                    _accepted;
+    std::uint64_t                                                 _round = 0;
+    unsigned int                                                  _best_replica = 0;
+    objective_value_t                                             _best_value = objective_value_t();
+};
+
+}
+}
+
+#endif // PARALLELTEMPERING_HPP
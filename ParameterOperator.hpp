@@ -106,7 +106,7 @@ namespace onion{
  *
  */
 template< typename solution_t, typename parameter_t >
-class ParameterOperator : public NonCopyable, public ComponentID
+class ParameterOperator : public NonCopyable, public virtual ComponentID
 {
 public:
     /**
@@ -80,12 +80,16 @@ namespace onion{
  *  In these cases, in order to preserve the Framework's component model,
  *  <b>each different perturbation <i>must</i> be implemented as a separate component.</b>
  *
+ *  @remark Returning new solutions by value costs a copy per candidate. Operators whose transformations
+ *  change only a few components of a solution should also implement the in-place protocol of the
+ *  MoveOperator interface (apply and undo).
+ *
  *  This completes the definition of Perturbation operator in the Onion Franmework context. It is
  *  also the base to define its sister concept: the ParameterOperator.
  *
  */
 template< typename solution_t, typename perturbation_result_t >
-class PerturbationOperator : public NonCopyable, public ComponentID
+class PerturbationOperator : public NonCopyable, public virtual ComponentID
 {
 public:
     /**
@@ -8,3 +8,4 @@
 using namespace onion;
 
 RandomEngine* RandomEngineProxy::_engine = new RandomSTL<>();
+thread_local RandomEngine* RandomEngineProxy::_thread_engine = nullptr;
@@ -26,11 +26,13 @@
  *
  *  - **The RandomEngine interface class :** Abstract Data Type that defines the set of available
  *  facilities and their protocol.
- *  - **Built-in RadomEngine implementations :** The framework provides two default implementations
+ *  - **Built-in RadomEngine implementations :** The framework provides three default implementations
  *   of the RandomEngine interface.
  *   + **RandomLegacyC:** implements RandomEngine using legacy C facilities. Namely: the rand(), time() and
  *   seed() functions from the C standard library.
  *   + **RandomSTL:** implements RandomEngine using the facilities provided by C++ (11 and above) STL.
+ *   + **RandomXoshiro256:** implements RandomEngine using four xoshiro256** generators advanced
+ *   side by side with SIMD instructions. It is the fastest option when many numbers are needed at once.
  *
  *  - **The RandomEngineProxy class:** this class creates the global random engine object and
  *  controls the access to it.
@@ -39,6 +41,11 @@
  *
  *   - **The SetRandomEngine() function:** configures the global RandomEngine object.
  *
+ *   - **The SetThreadRandomEngine() function:** configures the RandomEngine object of the calling thread.
+ *
+ *   - **The RandomStreams and ThreadRandomContext classes:** create reproducible, non-overlapping
+ *   engines for multi-threaded applications. See [RandomStreams.hpp](@ref onion/RandomStreams.hpp).
+ *
  *  The next example shows how to use the RNG system of the Onion Framework.
  *
  *      #include "onion/random.hpp"
@@ -52,6 +59,10 @@
  *      //  gets a random real number in the range [0,1]
  *      auto rndd = Random().uniform_real_01();
  *
+ *      // fills a buffer with 1000 random integers in the range [0,99]
+ *      std::vector<unsigned> indices(1000);
+ *      Random().fill_uniform_int_between(indices.data(), indices.size(), 0, 99);
+ *
  *  <h3><a id="perf_comp">Performance comparisson</a></h3>
  *
  *  The next tables preset performance results of a few different engines as implemented by some compilers.
@@ -87,8 +98,10 @@
  *
  *  **Notes**
  *
- *  <a id="note1">1</a>: Reference and Legacy C implementations produce results that
+ *  <a id="note1">1</a>: The reference implementation produces results that
  *  are sligtly <a href="classonion_1_1_random_legacy_c.html#c_stdlib_non_uniform">non uniform</a>.
+ *  So did Legacy C when these tables were measured. All engines now share the exactly uniform conversions of
+ *  [RandomDistributions.hpp](@ref onion/RandomDistributions.hpp).
  *
  *  <hr>
  *  @copyright 2022 André Ladeira / Onion Framework.
@@ -123,7 +136,7 @@ private:
      */
 
     static inline RandomEngine& getRandomEngine(){
-        return (*_engine);
+        return _thread_engine ? (*_thread_engine) : (*_engine);
     }
     /**
      * @brief Sets the global RandomEngine object.
@@ -132,9 +145,20 @@ private:
     static inline void setRandomEngine(RandomEngine* newEngine){
         _engine = newEngine;
     }
+    /**
+     * @brief Sets the RandomEngine object of the calling thread.
+     * @return The engine previously set for the calling thread, possibly nullptr.
+     *
+     */
+    static inline RandomEngine* setThreadRandomEngine(RandomEngine* newEngine){
+        auto previous  = _thread_engine;
+        _thread_engine = newEngine;
+        return previous;
+    }
 
     friend inline RandomEngine& Random();
     friend inline void SetRandomEngine(RandomEngine* newEngine);
+    friend inline RandomEngine* SetThreadRandomEngine(RandomEngine* newEngine);
     /**
      * @brief Class constructor.
      *
@@ -152,11 +176,22 @@ private:
      *
      */
     static RandomEngine* _engine;
+    /**
+     * @brief RandomEngine object of the calling thread.
+     *
+     * When set, it takes precedence over the global object, so each thread can
+     * have its own engine without any synchronization. By default it is nullptr
+     * and the thread uses the global RandomEngine object.
+     *
+     * See ThreadRandomContext for the recommended way to set it.
+     */
+    static thread_local RandomEngine* _thread_engine;
 };
 
 /**
  * @brief Return access point to the global RandomEngine object
  *
+ * If the calling thread has its own engine (see SetThreadRandomEngine()), that engine is returned instead.
  */
 
 inline RandomEngine& Random(){
@@ -172,5 +207,16 @@ inline void SetRandomEngine(RandomEngine* newEngine){
      return RandomEngineProxy::setRandomEngine(newEngine);
 }
 
+/**
+ * @brief Sets the RandomEngine object used by Random() in the calling thread.
+ * @param newEngine the engine. nullptr makes the thread use the global object again.
+ * @return The engine previously set for the calling thread, possibly nullptr.
+ *
+ * The caller keeps the ownership of the engine.
+ */
+inline RandomEngine* SetThreadRandomEngine(RandomEngine* newEngine){
+     return RandomEngineProxy::setThreadRandomEngine(newEngine);
+}
+
 }
 #endif // RANDOM_HPP
@@ -0,0 +1,95 @@
+/** @file onion/RandomDistributions.hpp
+ *  @brief Conversions from random bits to the distributions required by the RandomEngine interface.
+ *
+ *  Every RandomEngine implementation has to turn the raw output of its generator into
+ *  integers in a range [min,max] and into real numbers in [0,1). Doing it right is subtle:
+ *
+ *  - `x % range` is biased whenever range does not divide 2<sup>32</sup>, and a division is slow.
+ *  - Constructing a `std::uniform_int_distribution` on every call hides a division and a few branches.
+ *  - Dividing by `RAND_MAX` or by 2<sup>32</sup> gives real numbers with 31 or 32 bits of resolution,
+ *   instead of the 53 bits of a double.
+ *
+ *  The functions in this header implement the conversions once, so that all engines share them:
+ *
+ *  - bounded_int(): D. Lemire's *nearly divisionless* method
+ *   (<a href="https://arxiv.org/abs/1805.10941">Fast Random Integer Generation in an Interval</a>).
+ *   It maps a random word (32 bits by default) to [0,range) with one multiplication. A division is only needed
+ *   in the rare case the word falls in the biased zone, and then a new word is drawn (rejection).
+ *   The result is exactly uniform.
+ *
+ *  - real_01(): takes the 53 most significant bits of a 64-bit word and scales them by 2<sup>-53</sup>.
+ *   The result is exactly uniform over the 2<sup>53</sup> representable values in [0,1).
+ *
+ *  tests/random_distributions.cpp checks both with chi-square tests, and bench/random_bench.cpp times them
+ *  against the STL distributions. Each builds with a single g++ command, given in the file.
+ *
+ *  <hr>
+ *  @copyright 2022 André Ladeira / Onion Framework.
+ */
+#ifndef RANDOMDISTRIBUTIONS_HPP
+#define RANDOMDISTRIBUTIONS_HPP
+
+#include <cstdint>
+
+namespace onion{
+
+/**
+ * @brief Maps a uniformly distributed word to an integer uniformly distributed in [0,range).
+ * @param word_bits the number of random bits in each word, at most 32 (default).
+ * @param [in] x a uniformly distributed word.
+ * @param [in] range the size of the interval, at most 2^word_bits. Zero means the whole 32-bit range.
+ * @param [in] next function object that returns a new uniformly distributed word.
+ *  It is only called when x falls in the biased zone, which happens with probability < range / 2^word_bits.
+ * @return An integer uniformly distributed in [0,range).
+ *
+ * Engines whose words are narrower than 32 bits (like `rand()`) can use this function with fewer bits
+ * for small ranges, instead of spending several calls to build a full word.
+ */
+template< unsigned word_bits = 32, typename next_t >
+inline std::uint32_t bounded_int(std::uint32_t x, std::uint32_t range, next_t&& next) noexcept {
+    static_assert( word_bits > 0 && word_bits <= 32, "word_bits must be in [1,32]" );
+    constexpr std::uint64_t mask = ( std::uint64_t(1) << word_bits ) - 1;
+    if (!range) return x;
+    std::uint64_t m   = static_cast<std::uint64_t>(x) * range;
+    auto          low = static_cast<std::uint32_t>( m & mask );
+    if ( low < range ){
+        const auto threshold = static_cast<std::uint32_t>( ( mask + 1 - range ) % range );
+        while ( low < threshold ){
+            m   = static_cast<std::uint64_t>( next() ) * range;
+            low = static_cast<std::uint32_t>( m & mask );
+        }
+    }
+    return static_cast<std::uint32_t>( m >> word_bits );
+}
+
+/**
+ * @brief Draws an integer uniformly distributed in [0,range).
+ * @param word_bits the number of random bits in each word, at most 32 (default).
+ * @param [in] range the size of the interval, at most 2^word_bits. Zero means the whole 32-bit range.
+ * @param [in] next function object that returns a uniformly distributed word.
+ */
+template< unsigned word_bits = 32, typename next_t >
+inline std::uint32_t bounded_int(std::uint32_t range, next_t&& next) noexcept {
+    return bounded_int<word_bits>( next(), range, next );
+}
+
+/**
+ * @brief Converts a uniformly distributed 64-bit word to a real number uniformly distributed in [0,1).
+ * @param [in] x a uniformly distributed 64-bit word. Only its 53 most significant bits are used.
+ */
+inline double real_01(std::uint64_t x) noexcept {
+    return static_cast<double>( x >> 11 ) * ( 1.0 / 9007199254740992.0 ); // 2^-53
+}
+
+/**
+ * @brief Converts two uniformly distributed 32-bit words to a real number uniformly distributed in [0,1).
+ * @param [in] high the most significant word.
+ * @param [in] low the least significant word.
+ */
+inline double real_01(std::uint32_t high, std::uint32_t low) noexcept {
+    return real_01( ( static_cast<std::uint64_t>(high) << 32 ) | low );
+}
+
+}
+
+#endif // RANDOMDISTRIBUTIONS_HPP
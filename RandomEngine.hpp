@@ -6,6 +6,8 @@
 #ifndef RANDOMENGINE_HPP
 #define RANDOMENGINE_HPP
 
+#include <cstddef>
+
 namespace onion{
 
 /** @class RandomEngine
@@ -66,6 +68,40 @@ public:
      *
      */
     virtual void seed(int_t s = 0) noexcept = 0;
+    /**
+     * @brief Fills a buffer with pseudo-random integers.
+     * @param [out] out pointer to the first element of the buffer.
+     * @param [in] n number of integers to generate.
+     *
+     * The integers follow the same distribution as uniform_int().
+     * The default implementation calls uniform_int() n times. Implementations that
+     * can generate several numbers at once (see RandomXoshiro256) should override it.
+     */
+    virtual void fill_uniform_int(int_t* out, std::size_t n) noexcept {
+        for (std::size_t i = 0; i < n; ++i) out[i] = uniform_int();
+    }
+    /**
+     * @brief Fills a buffer with pseudo-random integers in the [*min*,*max*] interval.
+     * @param [out] out pointer to the first element of the buffer.
+     * @param [in] n number of integers to generate.
+     * @param [in] min the lower limit of the interval.
+     * @param [in] max the upper limit of the interval.
+     *
+     * The default implementation calls uniform_int_between() n times.
+     */
+    virtual void fill_uniform_int_between(int_t* out, std::size_t n, int_t min, int_t max) noexcept {
+        for (std::size_t i = 0; i < n; ++i) out[i] = uniform_int_between(min,max);
+    }
+    /**
+     * @brief Fills a buffer with real numbers between 0 and 1.
+     * @param [out] out pointer to the first element of the buffer.
+     * @param [in] n number of real numbers to generate.
+     *
+     * The default implementation calls uniform_real_01() n times.
+     */
+    virtual void fill_uniform_real_01(real_t* out, std::size_t n) noexcept {
+        for (std::size_t i = 0; i < n; ++i) out[i] = uniform_real_01();
+    }
 
 protected:
 
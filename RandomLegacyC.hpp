@@ -6,6 +6,8 @@
 #define RANDOMLEGACYC_HPP
 
 #include "onion/RandomEngine.hpp"
+#include "onion/RandomDistributions.hpp"
+#include <cstdint>
 #include <cstdlib>
 #include <ctime>
 
@@ -32,12 +34,16 @@ namespace onion{
  *
  *  <h3><a id="c_stdlib_non_uniform">Random numbers generated by the C stdlib `rand()` function are not uniform</a></h3>
  *
- *  The `rand()` function from `<cstdlib>` produces random numbers that are not exactly uniform.
- *  Therefore, this implementation also do not produce pseudo-random numbers that are exactly uniformly
- *  distributed in the given intervals.
- *
+ *  The `rand()` function from `<cstdlib>` returns numbers in [0,RAND_MAX], which is usually much smaller
+ *  than the integer range, and the usual `rand() % range` idiom is biased.
  *  For more information, please refer to the
  *  <a href="https://cplusplus.com/reference/cstdlib/rand/">rand() function documentation</a>.
+ *
+ *  To avoid both problems this implementation builds full words from the 31 (if RAND_MAX ≥ 2<sup>31</sup> - 1)
+ *  or 15 least significant bits of consecutive `rand()` calls (every conforming implementation has
+ *  RAND_MAX ≥ 32767 and, in practice, RAND_MAX + 1 is a power of two) and uses the shared conversions of
+ *  [RandomDistributions.hpp](@ref onion/RandomDistributions.hpp). The results are uniformly distributed,
+ *  but their quality is still the quality of the underlying `rand()` generator.
  */
 class RandomLegacyC final : public RandomEngine{
 
@@ -55,32 +61,34 @@ public:
     virtual ~RandomLegacyC() = default;
 
     /**
-     * @brief Implemantation using rand() from `<cstdlib>`
+     * @brief Implemantation using two (or three) rand() calls from `<cstdlib>`
      *
-     * This implementation produces results that are slighly non-uniformly distributed.
      * For more details see the [RandomLegacyC class documentation](@ref RandomLegacyC)
      */
     virtual inline int_t uniform_int() noexcept {
-        return std::rand();
+        return static_cast<int_t>( bits(32) );
     }
     /**
-     * @brief Implemantation using rand() from `<cstdlib>`
+     * @brief Implemantation using bounded_int().
      *
-     * This implementation produces results that are slighly non-uniformly distributed.
+     * Intervals with up to 2^rand_bits integers need a single rand() call (most of the time).
      * For more details see [the RandomLegacyC class documentation](@ref RandomLegacyC)
      */
     virtual inline int_t uniform_int_between(int_t min, int_t max) noexcept {
-        auto range = max-min+1;
-        return uniform_int() % range + min;
+        const int_t range = max - min + 1;
+        if ( range && range <= ( int_t(1) << rand_bits ) ){
+            return min + bounded_int<rand_bits>( range, []{ return static_cast<int_t>( bits(rand_bits) ); } );
+        }
+        return min + bounded_int( range, [this]{ return uniform_int(); } );
     }
     /**
-     * @brief Implemantation using rand() from `<cstdlib>`
+     * @brief Implemantation using two (or four) rand() calls from `<cstdlib>`
      *
-     * This implementation produces results that are slighly non-uniformly distributed.
+     * Returns a number in the range [0,1) with 53 bits of resolution.
      * For more details see [the RandomLegacyC class documentation](@ref RandomLegacyC)
      */
     virtual real_t uniform_real_01() noexcept {
-        return static_cast<real_t>( std::rand() ) / RAND_MAX ;
+        return real_01( bits(53) << 11 );
     }
     /**
      * @brief Implemantation using srand() and time(nullptr)
@@ -93,6 +101,28 @@ public:
             std::srand( static_cast<unsigned int>( s ) );
     }
 
+private:
+
+    /**
+     * @brief Number of uniformly distributed bits used from each rand() call.
+     */
+    static constexpr unsigned rand_bits = ( RAND_MAX >= 0x7FFFFFFF ) ? 31 : 15;
+    /**
+     * @brief Returns an integer uniformly distributed in [0, 2^nbits), nbits ≤ 64.
+     *
+     * Uses the rand_bits least significant bits of each rand() call.
+     */
+    static inline std::uint64_t bits(unsigned nbits) noexcept {
+        std::uint64_t x = 0;
+        unsigned      n = 0;
+        while ( n < nbits ){
+            const unsigned take = ( nbits - n < rand_bits ) ? nbits - n : rand_bits;
+            x  = ( x << take ) | ( static_cast<std::uint64_t>( std::rand() ) & ( ( std::uint64_t(1) << take ) - 1 ) );
+            n += take;
+        }
+        return x;
+    }
+
 };
 
 }
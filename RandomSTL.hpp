@@ -12,7 +12,10 @@
 #define RANDOMSTL_HPP
 
 #include "RandomEngine.hpp"
+#include "RandomDistributions.hpp"
+#include <cstdint>
 #include <random>
+#include <type_traits>
 
 namespace onion{
 
@@ -25,6 +28,12 @@ namespace onion{
  *  In other words: altough STL random engines do implement the same
  *  functions (what make it possible using them as template parameters),
  *  they do not share a base class and are not polymorphic objects.
+ *
+ *  When the engine produces at least 32 uniformly distributed bits per call (e.g. `std::mt19937`,
+ *  `std::mt19937_64`), integers in an interval and real numbers are obtained with the shared conversions of
+ *  [RandomDistributions.hpp](@ref onion/RandomDistributions.hpp), directly from the engine output.
+ *  Narrower engines, like the default `std::minstd_rand`, whose range is not a power of two,
+ *  use the STL distributions.
  */
 template< class random_engine_t = std::minstd_rand >
 class RandomSTL final : public RandomEngine{
@@ -41,25 +50,27 @@ public:
      */
     virtual ~RandomSTL() = default;
     /**
-     * @brief Implemantation using STL uniform_int_distribution<>`
+     * @brief Implemantation using the engine output or STL uniform_int_distribution<>`
      *
      */
     virtual inline int_t uniform_int() noexcept {
-        return std::uniform_int_distribution<int_t>()(random_engine);
+        return bits32( full_width() );
     }
     /**
-     * @brief Implemantation using STL uniform_int_distribution<>`
+     * @brief Implemantation using bounded_int() or STL uniform_int_distribution<>`
      *
+     * See [RandomDistributions.hpp](@ref onion/RandomDistributions.hpp).
      */
     virtual inline int_t uniform_int_between(int_t min, int_t max) noexcept {
-        return std::uniform_int_distribution<int_t>(min,max)(random_engine);
+        return between( min, max, full_width() );
     }
     /**
-     * @brief Implemantation using STL uniform_real_distribution<>`
+     * @brief Implemantation using real_01() or STL uniform_real_distribution<>`
      *
+     * Returns a number in the range [0,1).
      */
     virtual inline real_t uniform_real_01() noexcept {
-        return std::uniform_real_distribution<real_t>(0.0,1.0)(random_engine);
+        return real( full_width() );
     }
     /**
      * @brief Implemantation of seed() using the given STL engine seed() function.
@@ -73,12 +84,58 @@ public:
             random_engine.seed( r() );
         }
         else{
-            random_engine.seed(0);
+            random_engine.seed(s);
         }
     }
 
 private:
 
+    /**
+     * @brief Number of uniformly distributed bits in each engine output.
+     * Zero if the range of the engine is not a power of two.
+     */
+    static constexpr unsigned engine_bits(){
+        std::uint64_t range = static_cast<std::uint64_t>( random_engine_t::max() - random_engine_t::min() );
+        unsigned bits = 0;
+        while ( range & 1 ){
+            range >>= 1;
+            ++bits;
+        }
+        return range ? 0 : bits;
+    }
+
+    using full_width = std::integral_constant< bool, ( engine_bits() >= 32 ) >;
+
+    inline std::uint64_t raw() noexcept {
+        return static_cast<std::uint64_t>( random_engine() - random_engine_t::min() );
+    }
+
+    inline int_t bits32(std::true_type) noexcept {
+        return static_cast<int_t>( raw() >> ( engine_bits() - 32 ) );
+    }
+
+    inline int_t bits32(std::false_type) noexcept {
+        return std::uniform_int_distribution<int_t>()(random_engine);
+    }
+
+    inline int_t between(int_t min, int_t max, std::true_type) noexcept {
+        return min + bounded_int( max - min + 1, [this]{ return bits32( std::true_type() ); } );
+    }
+
+    inline int_t between(int_t min, int_t max, std::false_type) noexcept {
+        return std::uniform_int_distribution<int_t>(min,max)(random_engine);
+    }
+
+    inline real_t real(std::true_type) noexcept {
+        if ( engine_bits() >= 53 ) return real_01( raw() << ( 64 - engine_bits() ) );
+        const int_t high = bits32( std::true_type() );
+        return real_01( high, bits32( std::true_type() ) );
+    }
+
+    inline real_t real(std::false_type) noexcept {
+        return std::uniform_real_distribution<real_t>(0.0,1.0)(random_engine);
+    }
+
     random_engine_t random_engine;
 
 };
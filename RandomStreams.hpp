@@ -0,0 +1,136 @@
+/** @file onion/RandomStreams.hpp
+ *  @brief Reproducible, non-overlapping random number streams for multi-threaded applications.
+ *
+ *  The global RandomEngine object returned by Random() is shared by every thread.
+ *  Using it from several threads at the same time is a data race and, even if it was
+ *  protected by a lock, it would be a point of contention.
+ *
+ *  The classes in this header give each thread its own engine:
+ *
+ *  - **RandomStreams:** the seed manager. From a single master seed *S* it creates any number
+ *  of RandomXoshiro256 engines, one per stream id. Stream *k* is the engine seeded with *S* and then
+ *  advanced *k* × 2<sup>192</sup> steps (RandomXoshiro256::long_jump()), so streams never overlap.
+ *  - **ThreadRandomContext:** owns the engine of a stream and installs it as the engine of the calling
+ *  thread for its lifetime (RAII). While it exists, Random() returns the thread engine.
+ *
+ *  As long as thread *t* always uses stream *t*, a run with seed *S* and *T* threads is deterministic.
+ *
+ *      #include "onion/RandomStreams.hpp"
+ *      ...
+ *      RandomStreams streams(seed);
+ *
+ *      std::vector<std::thread> threads;
+ *      for (unsigned t = 0; t < num_threads; ++t){
+ *          threads.emplace_back( [&streams,t]{
+ *              ThreadRandomContext context(streams, t);
+ *              auto rndi = Random().uniform_int_between(1,10);  // uses stream t
+ *              ...
+ *          });
+ *      }
+ *
+ *  <hr>
+ *  @copyright 2022 André Ladeira / Onion Framework.
+ */
+#ifndef RANDOMSTREAMS_HPP
+#define RANDOMSTREAMS_HPP
+
+#include "Random.hpp"
+#include "RandomXoshiro.hpp"
+#include "NonCopyable.hpp"
+#include <random>
+
+namespace onion{
+
+/** @class RandomStreams
+ *  @brief Creates reproducible, non-overlapping RandomEngine streams from a single master seed.
+ *
+ *  A RandomStreams object holds no engine. It only knows how to seed the engine of each stream,
+ *  so it can be shared by all threads without synchronization.
+ */
+class RandomStreams final : public NonCopyable{
+
+public:
+    using int_t = RandomEngine::int_t;
+    /**
+     * @brief Class constructor.
+     * @param master_seed the master seed.
+     *
+     * If no value (default) or zero is provided, a master seed is drawn from `std::random_device`.
+     * It can be retrieved with master_seed(), so the run can be reproduced later.
+     */
+    explicit RandomStreams(int_t master_seed = 0) noexcept : _master_seed(master_seed) {
+        while (!_master_seed){
+            std::random_device r;
+            _master_seed = r();
+        }
+    }
+    /**
+     * @brief Class destructor.
+     */
+    virtual ~RandomStreams() = default;
+    /**
+     * @brief Returns the master seed.
+     */
+    int_t master_seed() const noexcept { return _master_seed; }
+    /**
+     * @brief Seeds an engine so that it produces the sequence of the given stream.
+     * @param [out] engine the engine to be seeded.
+     * @param [in] stream the stream id.
+     *
+     * The cost is proportional to the stream id (one long jump per id). It is meant to be paid once,
+     * when a thread starts.
+     */
+    void seed(RandomXoshiro256& engine, unsigned stream) const noexcept {
+        engine.seed(_master_seed);
+        for (unsigned k = 0; k < stream; ++k) engine.long_jump();
+    }
+
+private:
+
+    int_t _master_seed;
+};
+
+/** @class ThreadRandomContext
+ *  @brief Owns the RandomEngine of a stream and sets it as the engine of the calling thread.
+ *
+ *  The engine is installed by the constructor and the previous engine of the thread
+ *  is restored by the destructor. Therefore, contexts must be created and destroyed
+ *  by the same thread and can be nested.
+ *
+ *  The engine lives inside the context object: no heap allocation is performed.
+ */
+class ThreadRandomContext final : public NonCopyable{
+
+public:
+    /**
+     * @brief Class constructor.
+     * @param streams the seed manager.
+     * @param stream the stream id used by the calling thread.
+     */
+    ThreadRandomContext(const RandomStreams& streams, unsigned stream) noexcept {
+        streams.seed(_engine, stream);
+        _previous = SetThreadRandomEngine(&_engine);
+    }
+    /**
+     * @brief Class destructor. Restores the previous engine of the calling thread.
+     */
+    virtual ~ThreadRandomContext(){
+        SetThreadRandomEngine(_previous);
+    }
+    /**
+     * @brief Returns the engine of this context.
+     *
+     * Calling the engine directly, instead of through Random(), avoids the thread-local lookup
+     * and allows the compiler to inline the calls.
+     */
+    RandomXoshiro256& engine() noexcept { return _engine; }
+
+private:
+
+    RandomXoshiro256 _engine;
+    RandomEngine*    _previous = nullptr;
+};
+
+}
+
+#endif // RANDOMSTREAMS_HPP
@@ -0,0 +1,306 @@
+/** @file onion/RandomXoshiro.hpp
+ *  @brief Implementation of the RandomEngine interface using a vectorized xoshiro256** generator.
+ *  <hr>
+ *  @copyright 2022 André Ladeira / Onion Framework.
+ */
+#ifndef RANDOMXOSHIRO_HPP
+#define RANDOMXOSHIRO_HPP
+
+#include "RandomEngine.hpp"
+#include "RandomDistributions.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace onion{
+
+/** @class RandomXoshiro256
+ *  @brief Implements the RandomEngine interface using four interleaved xoshiro256** generators.
+ *
+ *  <a href="https://prng.di.unimi.it/">xoshiro256**</a> is a small, fast, all-purpose generator
+ *  with a period of 2<sup>256</sup> - 1. Its state transition uses only shifts, xors and additions
+ *  (the multiplications by 5 and 9 are shift-and-add), so several independent generators can be
+ *  advanced at the same time using SIMD instructions.
+ *
+ *  This engine keeps `lanes` = 4 generators side by side (structure of arrays). Each step of the
+ *  engine advances all of them and produces 4 64-bit words:
+ *
+ *  - With AVX2 the 4 lanes are advanced in a single 256-bit register.
+ *  - With SSE2 they are advanced in two 128-bit registers.
+ *  - Otherwise a scalar loop is used.
+ *
+ *  The three code paths produce exactly the same sequence, so results do not depend on the
+ *  instruction set the application was compiled for.
+ *
+ *  Lane *k* starts 2<sup>128</sup> × *k* steps ahead of lane 0 (see jump()), so the lanes never overlap.
+ *
+ *  Integers in an interval and real numbers are obtained with the shared conversions of
+ *  [RandomDistributions.hpp](@ref onion/RandomDistributions.hpp).
+ *
+ *  Single draws ( uniform_int(), uniform_real_01() ...) are served from a small internal buffer that
+ *  is refilled several steps at a time. The batch methods ( fill_uniform_int() ... ) generate
+ *  directly in blocks and are the fastest way to get large amounts of random numbers.
+ *
+ *  **Performance**
+ *
+ *  Time to generate 10 million numbers relative to RandomSTL<std::minstd_rand>,
+ *  g++ 12.2.0 -O2 -mavx2. A result of 0.5 means the engine takes half the time of the reference.
+ *  Both engines are called through the RandomEngine interface. The figures are the medians of 5 runs of
+ *  bench/random_bench.cpp, which prints this table and builds with the g++ command given in the file.
+ *
+ *  | Test                                  | RandomSTL (LCG) | Xoshiro, single draws | Xoshiro, fill_*  |
+ *  | :----                                 | :----:          | :----:                | :----:           |
+ *  | integers in [0,max_int]               | 1.00            | 0.14                  | 0.05             |
+ *  | integers in [1,1000]                  | 1.00            | 0.51                  | 0.27             |
+ *  | real numbers in [0,1)                 | 1.00            | 0.35                  | 0.21             |
+ */
+class RandomXoshiro256 final : public RandomEngine{
+
+public:
+    /**
+     * @brief Number of generators advanced side by side.
+     */
+    static constexpr std::size_t lanes = 4;
+    /**
+     * @brief Class constructor
+     */
+    RandomXoshiro256() noexcept {
+        seed();
+    }
+    /**
+     * @brief Class destructor
+     */
+    virtual ~RandomXoshiro256() = default;
+    /**
+     * @brief Implementation using the upper 32 bits of a xoshiro256** output.
+     */
+    virtual inline int_t uniform_int() noexcept {
+        return static_cast<int_t>( next() >> 32 );
+    }
+    /**
+     * @brief Implementation using Lemire's multiply-shift method with rejection.
+     *
+     * The result is exactly uniform and, in most calls, no division is performed.
+     */
+    virtual inline int_t uniform_int_between(int_t min, int_t max) noexcept {
+        return min + bounded_int( max - min + 1, [this]{ return uniform_int(); } );
+    }
+    /**
+     * @brief Implementation using the upper 53 bits of a xoshiro256** output.
+     *
+     * Returns a number in the range [0,1).
+     */
+    virtual inline real_t uniform_real_01() noexcept {
+        return real_01( next() );
+    }
+    /**
+     * @brief Seeds all lanes.
+     *
+     * The seed is expanded to 256 bits using splitmix64, as recommended by the authors of xoshiro.
+     * If s = 0, `std::random_device` is used as the high resolution seeding mechanism.
+     */
+    virtual void seed(int_t s = 0) noexcept {
+        std::uint64_t x = s;
+        if (!s){
+            std::random_device r;
+            x = ( static_cast<std::uint64_t>( r() ) << 32 ) | r();
+        }
+        static const std::uint64_t jump_poly[4] = {
+            0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+        std::uint64_t state[4];
+        for (auto& w : state) w = splitmix64(x);
+
+        for (std::size_t l = 0; l < lanes; ++l){
+            for (std::size_t w = 0; w < 4; ++w) _s[w][l] = state[w];
+            jump(state, jump_poly);
+        }
+        _next = buffer_size;
+    }
+    /**
+     * @brief Advances every lane 2<sup>192</sup> steps.
+     *
+     * Since lanes are 2<sup>128</sup> steps apart, calling long_jump() *k* times on
+     * identically seeded engines produces non-overlapping sequences for each *k*.
+     */
+    void long_jump() noexcept {
+        static const std::uint64_t long_jump_poly[4] = {
+            0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL, 0x77710069854ee241ULL, 0x39109bb02acbe635ULL };
+        for (std::size_t l = 0; l < lanes; ++l){
+            std::uint64_t state[4] = { _s[0][l], _s[1][l], _s[2][l], _s[3][l] };
+            jump(state, long_jump_poly);
+            for (std::size_t w = 0; w < 4; ++w) _s[w][l] = state[w];
+        }
+        _next = buffer_size;
+    }
+    /**
+     * @brief Generates n integers at a time, four lanes per step.
+     */
+    virtual void fill_uniform_int(int_t* out, std::size_t n) noexcept {
+        static_assert( sizeof(int_t) * 2 == sizeof(std::uint64_t), "int_t is expected to have 32 bits" );
+        constexpr std::size_t per_word = 2;
+        while (n){
+            refill();
+            const std::size_t k = std::min( n, buffer_size * per_word );
+            std::memcpy( out, _buffer, k * sizeof(int_t) );
+            _next = ( k + per_word - 1 ) / per_word;
+            out += k;
+            n   -= k;
+        }
+    }
+    /**
+     * @brief Generates n integers in the [*min*,*max*] interval using Lemire's method.
+     */
+    virtual void fill_uniform_int_between(int_t* out, std::size_t n, int_t min, int_t max) noexcept {
+        const int_t range = max - min + 1;
+        fill_uniform_int(out,n);
+        if (!range){
+            for (std::size_t i = 0; i < n; ++i) out[i] += min;
+            return;
+        }
+        for (std::size_t i = 0; i < n; ++i){
+            out[i] = min + bounded_int( out[i], range, [this]{ return uniform_int(); } );
+        }
+    }
+    /**
+     * @brief Generates n real numbers in the range [0,1).
+     */
+    virtual void fill_uniform_real_01(real_t* out, std::size_t n) noexcept {
+        while (n){
+            refill();
+            const std::size_t k = std::min( n, std::size_t(buffer_size) );
+            for (std::size_t i = 0; i < k; ++i){
+                out[i] = real_01( _buffer[i] );
+            }
+            _next = k;
+            out += k;
+            n   -= k;
+        }
+    }
+
+private:
+
+    static constexpr std::size_t buffer_size = 64;
+
+    static inline std::uint64_t rotl(std::uint64_t x, int k) noexcept {
+        return ( x << k ) | ( x >> ( 64 - k ) );
+    }
+
+    static inline std::uint64_t splitmix64(std::uint64_t& x) noexcept {
+        std::uint64_t z = ( x += 0x9e3779b97f4a7c15ULL );
+        z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+        z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL;
+        return z ^ ( z >> 31 );
+    }
+
+    static inline void step(std::uint64_t (&s)[4]) noexcept {
+        const std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl( s[3], 45 );
+    }
+
+    static void jump(std::uint64_t (&s)[4], const std::uint64_t (&poly)[4]) noexcept {
+        std::uint64_t j[4] = { 0, 0, 0, 0 };
+        for (auto p : poly){
+            for (int b = 0; b < 64; ++b){
+                if ( p & ( std::uint64_t(1) << b ) ){
+                    for (std::size_t w = 0; w < 4; ++w) j[w] ^= s[w];
+                }
+                step(s);
+            }
+        }
+        for (std::size_t w = 0; w < 4; ++w) s[w] = j[w];
+    }
+
+    inline std::uint64_t next() noexcept {
+        if ( _next == buffer_size ) refill();
+        return _buffer[_next++];
+    }
+
+    inline void refill() noexcept {
+        generate( _buffer, buffer_size / lanes );
+        _next = 0;
+    }
+
+    /**
+     * @brief Advances all lanes *steps* times, writing lanes × steps words to out.
+     */
+    void generate(std::uint64_t* out, std::size_t steps) noexcept {
+#if defined(__AVX2__)
+        __m256i s0 = _mm256_load_si256( reinterpret_cast<const __m256i*>( _s[0] ) );
+        __m256i s1 = _mm256_load_si256( reinterpret_cast<const __m256i*>( _s[1] ) );
+        __m256i s2 = _mm256_load_si256( reinterpret_cast<const __m256i*>( _s[2] ) );
+        __m256i s3 = _mm256_load_si256( reinterpret_cast<const __m256i*>( _s[3] ) );
+        for (std::size_t i = 0; i < steps; ++i){
+            __m256i r = _mm256_add_epi64( _mm256_slli_epi64(s1,2), s1 );                 // s1 * 5
+            r = _mm256_or_si256( _mm256_slli_epi64(r,7), _mm256_srli_epi64(r,57) );      // rotl 7
+            r = _mm256_add_epi64( _mm256_slli_epi64(r,3), r );                           // * 9
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( out + i * lanes ), r );
+
+            const __m256i t = _mm256_slli_epi64(s1,17);
+            s2 = _mm256_xor_si256(s2,s0);
+            s3 = _mm256_xor_si256(s3,s1);
+            s1 = _mm256_xor_si256(s1,s2);
+            s0 = _mm256_xor_si256(s0,s3);
+            s2 = _mm256_xor_si256(s2,t);
+            s3 = _mm256_or_si256( _mm256_slli_epi64(s3,45), _mm256_srli_epi64(s3,19) );
+        }
+        _mm256_store_si256( reinterpret_cast<__m256i*>( _s[0] ), s0 );
+        _mm256_store_si256( reinterpret_cast<__m256i*>( _s[1] ), s1 );
+        _mm256_store_si256( reinterpret_cast<__m256i*>( _s[2] ), s2 );
+        _mm256_store_si256( reinterpret_cast<__m256i*>( _s[3] ), s3 );
+#elif defined(__SSE2__)
+        __m128i s[4][2];
+        for (std::size_t w = 0; w < 4; ++w)
+            for (std::size_t h = 0; h < 2; ++h)
+                s[w][h] = _mm_load_si128( reinterpret_cast<const __m128i*>( _s[w] + 2 * h ) );
+        for (std::size_t i = 0; i < steps; ++i){
+            for (std::size_t h = 0; h < 2; ++h){
+                __m128i r = _mm_add_epi64( _mm_slli_epi64(s[1][h],2), s[1][h] );
+                r = _mm_or_si128( _mm_slli_epi64(r,7), _mm_srli_epi64(r,57) );
+                r = _mm_add_epi64( _mm_slli_epi64(r,3), r );
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( out + i * lanes + 2 * h ), r );
+
+                const __m128i t = _mm_slli_epi64(s[1][h],17);
+                s[2][h] = _mm_xor_si128(s[2][h],s[0][h]);
+                s[3][h] = _mm_xor_si128(s[3][h],s[1][h]);
+                s[1][h] = _mm_xor_si128(s[1][h],s[2][h]);
+                s[0][h] = _mm_xor_si128(s[0][h],s[3][h]);
+                s[2][h] = _mm_xor_si128(s[2][h],t);
+                s[3][h] = _mm_or_si128( _mm_slli_epi64(s[3][h],45), _mm_srli_epi64(s[3][h],19) );
+            }
+        }
+        for (std::size_t w = 0; w < 4; ++w)
+            for (std::size_t h = 0; h < 2; ++h)
+                _mm_store_si128( reinterpret_cast<__m128i*>( _s[w] + 2 * h ), s[w][h] );
+#else
+        for (std::size_t i = 0; i < steps; ++i){
+            for (std::size_t l = 0; l < lanes; ++l){
+                out[i * lanes + l] = rotl( _s[1][l] * 5, 7 ) * 9;
+                std::uint64_t lane[4] = { _s[0][l], _s[1][l], _s[2][l], _s[3][l] };
+                step(lane);
+                for (std::size_t w = 0; w < 4; ++w) _s[w][l] = lane[w];
+            }
+        }
+#endif
+    }
+
+    alignas(32) std::uint64_t _s[4][lanes];
+    alignas(32) std::uint64_t _buffer[buffer_size];
+    std::size_t _next = buffer_size;
+
+};
+
+}
+
+#endif // RANDOMXOSHIRO_HPP
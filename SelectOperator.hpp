@@ -9,39 +9,45 @@
 #include "ComponentID.hpp"
 #include "NonCopyable.hpp"
 #include "ComparissonOperator.hpp"
+#include <cstddef>
 
 namespace onion{
 
 /** @class SelectOperator
  *  @brief Defines the interface of SelectOperator components.
- *  @param objective_value_t.
  *  @param objective_value_t the type used to represent the value of a solution.
+ *  @param objective_function_result_t the type of a set of candidate values.
+ *  @param compare the comparisson that defines the better of two values.
  *
- *  The ObjectiveFunction is responsible for assigning a value to a solution of a problem.
+ *  The SelectOperator chooses among candidate solutions from their values: the parents of a generation,
+ *  the migrants of an island, the survivors of a population.
  *
- *  All algorithms are, in essence, ways of navigating the solution space. In this metaphore,
- *  the ObjectiveFunction can be interpreted as the compass that poits towards the right direction.
- *  It is the objective function that tells the algorithm if a solution A is better or worse than a solution B.
- *
- *  The ObjectiveFunction class is an ADT used to represent this
- *  concept and define the protocol of this functionality.
+ *  select() is the form used by the population-based algorithms: it receives the values of the
+ *  candidates as an array and returns the position of the chosen one. It is called once per choice, so
+ *  it should not allocate memory.
  *
  *  This is one of the fundamental components of the Onion Framework, the others being
- *  the CreateOperator, the PerturbationOperator and the SelectOperator.
+ *  the CreateOperator, the PerturbationOperator and the ObjectiveFunction.
  *
  */
 template< typename objective_value_t,
           typename objective_function_result_t,
           ComparissonOperator<objective_value_t> compare >
-class SelectOperator : public NonCopyable, public ComponentID
+class SelectOperator : public NonCopyable, public virtual ComponentID
 {
 public:
     virtual ~SelectOperator() = default;
     virtual  void operator()(const objective_value_t& best_sofar,
                              const objective_function_result_t& candidates) = 0;
+    /**
+     * @brief Chooses one of n candidates.
+     * @param [in] values the values of the candidates.
+     * @param [in] n the number of candidates, at least 1.
+     * @return The position of the chosen candidate, in [0, n).
+     */
+    virtual std::size_t select(const objective_value_t* values, std::size_t n) = 0;
 
 };
-
 }
 
 
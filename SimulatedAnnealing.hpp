@@ -0,0 +1,290 @@
+/** @file onion/SimulatedAnnealing.hpp
+ *  @brief This header introduces the Simulated Annealing algorithm.
+ *  <hr>
+ *  @copyright 2022 André Ladeira / Onion Framework.
+ */
+#ifndef SIMULATEDANNEALING_HPP
+#define SIMULATEDANNEALING_HPP
+
+#include "Algorithm.hpp"
+#include "ComparissonOperator.hpp"
+#include "CreateOperator.hpp"
+#include "ObjectiveFunction.hpp"
+#include "Random.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace onion{
+namespace algorithms{
+
+/**
+ * @brief Approximation of exp(x) for x <= 0, with a relative error below 2e-7.
+ *
+ * exp(x) = 2^n 2^f with n = round(x / ln 2) and |f| <= 1/2: 2^f is a degree 6 Taylor polynomial
+ * and 2^n is written directly in the exponent bits. Returns 0 for x < -700. No branch on the path of
+ * the usual arguments, no library call.
+ */
+inline double fast_exp(double x) noexcept {
+    if ( x < -700 ) return 0;
+    const double t = x * 1.44269504088896340736;     // log2(e)
+    const double n = std::floor(t + 0.5);
+    const double u = ( t - n ) * 0.69314718055994530942;
+    const double p = 1 + u * ( 1 + u * ( 1.0 / 2 + u * ( 1.0 / 6 + u * ( 1.0 / 24 + u * ( 1.0 / 120 + u * ( 1.0 / 720 ) ) ) ) ) );
+    const std::uint64_t bits = std::uint64_t( static_cast<std::int64_t>(n) + 1023 ) << 52;
+    double scale;
+    std::memcpy( &scale, &bits, sizeof(scale) );
+    return p * scale;
+}
+
+/**
+ * @brief Temperature schedule of a SimulatedAnnealing.
+ *
+ * The temperature is constant during a level of `moves_per_level` moves, then updated:
+ *
+ * - geometric : T = alpha T. The search ends when T < final_temperature.
+ * - adaptive  : T = alpha T if more than target_acceptance of the moves of the level were accepted,
+ *               T = T / alpha otherwise. The acceptance rate then stays near the target; the search
+ *               only ends with the budget.
+ * - reheating : geometric, but instead of ending, T = reheat_temperature when T < final_temperature
+ *               or when the best solution did not improve for reheat_after levels.
+ *
+ * Use the factory functions to build a schedule.
+ */
+struct schedule_t{
+    enum class kind_t{ geometric, adaptive, reheating };
+
+    kind_t        kind                = kind_t::geometric;
+    double        initial_temperature = 1;
+    double        alpha               = 0.95;
+    std::uint64_t moves_per_level     = 1000;
+    double        final_temperature   = 1e-3;
+    double        target_acceptance   = 0.2;
+    double        reheat_temperature  = 1;
+    unsigned int  reheat_after        = 10;
+
+    static schedule_t geometric(double initial_temperature, double alpha, std::uint64_t moves_per_level,
+                                double final_temperature){
+        schedule_t s;
+        s.kind                = kind_t::geometric;
+        s.initial_temperature = initial_temperature;
+        s.alpha               = alpha;
+        s.moves_per_level     = moves_per_level;
+        s.final_temperature   = final_temperature;
+        return s;
+    }
+
+    static schedule_t adaptive(double initial_temperature, double target_acceptance, double alpha,
+                               std::uint64_t moves_per_level){
+        schedule_t s;
+        s.kind                = kind_t::adaptive;
+        s.initial_temperature = initial_temperature;
+        s.target_acceptance   = target_acceptance;
+        s.alpha               = alpha;
+        s.moves_per_level     = moves_per_level;
+        return s;
+    }
+
+    static schedule_t reheating(double initial_temperature, double alpha, std::uint64_t moves_per_level,
+                                double final_temperature, double reheat_temperature, unsigned int reheat_after){
+        schedule_t s = geometric(initial_temperature, alpha, moves_per_level, final_temperature);
+        s.kind               = kind_t::reheating;
+        s.reheat_temperature = reheat_temperature;
+        s.reheat_after       = reheat_after;
+        return s;
+    }
+};
+
+/** @class SimulatedAnnealing
+ *  @brief Simulated annealing over a neighbourhood given by its delta components.
+ *  @param solution_t the type used to represent a solution to a problem.
+ *  @param parameter_t the type of the transformation parameters.
+ *  @param objective_value_t the type used to represent the value of a solution.
+ *  @param parameter_op_t a concrete ParameterOperator< solution_t, parameter_t >: draws the neighbours.
+ *  @param delta_t a concrete DeltaObjective< solution_t, parameter_t, objective_value_t >: evaluates them.
+ *  @param move_t a concrete MoveOperator< solution_t, parameter_t, ... >: applies the accepted ones, in place.
+ *  @param better the comparisson that defines an improvement: Less to minimize, Greater to maximize.
+ *
+ *  Each move draws a neighbour and evaluates its delta. A neighbour that is not worse is accepted;
+ *  one that is worse by w is accepted with probability exp(-w / T) (Metropolis criterion). A step is a
+ *  level of the schedule (see schedule_t).
+ *
+ *  The Metropolis test costs a multiplication, a fast_exp() and a comparison with a uniform number:
+ *  the uniform numbers are drawn from Random() 256 at a time (RandomEngine::fill_uniform_real_01), and only
+ *  consumed by worsening moves. As in LocalSearch, the components are called with qualified names, so the
+ *  only virtual calls of a move are those the ParameterOperator makes to draw the neighbour.
+ *
+ *  The current solution is changed in place. The best solution is copied from it lazily: only when a
+ *  move leaves a best solution that no later move improved, and at the end of each step.
+ */
+template< typename solution_t, typename parameter_t, typename objective_value_t,
+          typename parameter_op_t, typename delta_t, typename move_t,
+          ComparissonOperator<objective_value_t> better = Less<objective_value_t> >
+class SimulatedAnnealing : public Algorithm< solution_t, objective_value_t >
+{
+    static_assert( !std::is_abstract<parameter_op_t>::value && !std::is_abstract<delta_t>::value &&
+                   !std::is_abstract<move_t>::value, "SimulatedAnnealing needs the concrete component classes" );
+
+public:
+    /**
+     * @brief Class constructor.
+     * @param [in] create creates the starting solution.
+     * @param [in] objective evaluates the starting solution.
+     * @param [in] parameters draws the neighbours.
+     * @param [in] delta evaluates the neighbours.
+     * @param [in] move applies the accepted neighbours.
+     * @param [in] schedule the temperature schedule.
+     *
+     * The components must outlive the algorithm.
+     */
+    SimulatedAnnealing(CreateOperator<solution_t>& create, ObjectiveFunction<solution_t, objective_value_t>& objective,
+                       parameter_op_t& parameters, delta_t& delta, move_t& move, const schedule_t& schedule):
+        ComponentID( IDBuilder()
+                    .name("SimulatedAnnealing")
+                    .description("Simulated annealing with geometric, adaptive or reheating schedules.")
+                    .type("Algorithm")
+                    .version("v0.1.0")),
+        _create(create),
+        _objective(objective),
+        _parameters(parameters),
+        _delta(delta),
+        _move(move),
+        _schedule(schedule){
+    }
+
+    virtual void init(){
+        this->_stats = search_stats_t();
+        _current       = _create();
+        _value         = _objective(_current);
+        _best          = _current;
+        _best_value    = _value;
+        _best_pending  = false;
+        _temperature   = _schedule.initial_temperature;
+        _stalled       = 0;
+        _next_uniform  = num_uniforms;
+    }
+
+    virtual bool step(){
+        const std::uint64_t last_improvement = this->_stats.last_improvement;
+        const std::uint64_t accepted = anneal(_schedule.moves_per_level);
+
+        _stalled = this->_stats.last_improvement == last_improvement ? _stalled + 1 : 0;
+        switch ( _schedule.kind ){
+        case schedule_t::kind_t::geometric:
+            _temperature *= _schedule.alpha;
+            return _temperature >= _schedule.final_temperature;
+        case schedule_t::kind_t::adaptive:
+            if ( accepted > _schedule.target_acceptance * _schedule.moves_per_level ) _temperature *= _schedule.alpha;
+            else                                                                      _temperature /= _schedule.alpha;
+            return true;
+        case schedule_t::kind_t::reheating:
+            _temperature *= _schedule.alpha;
+            if ( _temperature < _schedule.final_temperature || _stalled >= _schedule.reheat_after ){
+                _temperature = _schedule.reheat_temperature;
+                _stalled     = 0;
+            }
+            return true;
+        }
+        return true;
+    }
+
+    virtual const solution_t& best() const { return _best; }
+
+    virtual objective_value_t best_value() const { return _best_value; }
+    /**
+     * @brief Performs moves at the current temperature, without changing it.
+     * @param [in] moves the number of moves.
+     * @return The number of accepted moves.
+     *
+     * The best solution is up to date when it returns.
+     */
+    std::uint64_t anneal(std::uint64_t moves){
+        const objective_value_t zero = objective_value_t();
+        const double            inverse_temperature = 1 / _temperature;
+        std::uint64_t           accepted = 0;
+
+        for (std::uint64_t k = 0; k < moves; ++k){
+            const parameter_t       p = _parameters.parameter_op_t::operator()();
+            const objective_value_t d = _delta.delta_t::operator()(_current, p);
+            ++this->_stats.evaluations;
+
+            if ( better(zero, d) ){
+                const double w = d < zero ? -double(d) : double(d);
+                if ( uniform() >= fast_exp( -w * inverse_temperature ) ) continue;
+            }
+
+            const objective_value_t value = _value + d;
+            const bool              new_best = better(value, _best_value);
+            if ( _best_pending && !new_best ){
+                _best = _current;
+                _best_pending = false;
+            }
+            _move.move_t::apply(_current, p);
+            _value = value;
+            ++accepted;
+            if ( new_best ){
+                _best_value   = value;
+                _best_pending = true;
+                this->_stats.last_improvement = this->_stats.evaluations;
+            }
+        }
+        this->_stats.moves += accepted;
+        flush_best();
+        return accepted;
+    }
+    /**
+     * @brief The current solution and its value.
+     */
+    const solution_t& current() const noexcept { return _current; }
+    objective_value_t value() const noexcept { return _value; }
+    /**
+     * @brief The temperature of the next step.
+     */
+    double temperature() const noexcept { return _temperature; }
+    /**
+     * @brief Sets the temperature of the next step, or of the next anneal().
+     */
+    void temperature(double t) noexcept { _temperature = t; }
+
+private:
+
+    static constexpr std::size_t num_uniforms = 256;
+
+    double uniform() noexcept {
+        if ( _next_uniform == num_uniforms ){
+            Random().fill_uniform_real_01(_uniforms, num_uniforms);
+            _next_uniform = 0;
+        }
+        return _uniforms[_next_uniform++];
+    }
+
+    void flush_best(){
+        if ( !_best_pending ) return;
+        _best = _current;
+        _best_pending = false;
+    }
+
+    CreateOperator<solution_t>&                       _create;
+    ObjectiveFunction<solution_t, objective_value_t>& _objective;
+    parameter_op_t&                                   _parameters;
+    delta_t&                                          _delta;
+    move_t&                                           _move;
+    schedule_t                                        _schedule;
+
+    solution_t        _current;
+    solution_t        _best;
+    objective_value_t _value        = objective_value_t();
+    objective_value_t _best_value   = objective_value_t();
+    bool              _best_pending = false;
+    double            _temperature  = 1;
+    unsigned int      _stalled      = 0;
+    double            _uniforms[num_uniforms];
+    std::size_t       _next_uniform = num_uniforms;
+};
+
+}
+}
+
+#endif // SIMULATEDANNEALING_HPP
@@ -0,0 +1,100 @@
+/** @file onion/SpscQueue.hpp
+ *  @brief Contains the definition of the SpscQueue class.
+ *  <hr>
+ *  @copyright 2022 André Ladeira / Onion Framework.
+ */
+#ifndef SPSCQUEUE_HPP
+#define SPSCQUEUE_HPP
+
+#include "NonCopyable.hpp"
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace onion{
+
+/** @class SpscQueue
+ *  @brief Bounded lock-free queue between one producer thread and one consumer thread.
+ *  @param T the type of the elements. It must be default constructible and copy assignable.
+ *
+ *  The elements live in a ring of slots created by the constructor: try_push() copies an element into
+ *  a slot and try_pop() swaps it out. For elements that own memory (a std::vector, a solution), the
+ *  buffers go round between the producer, the queue and the consumer, so that a queue in use does not
+ *  allocate memory.
+ *
+ *  Neither call blocks: try_push() fails when the queue is full and try_pop() when it is empty.
+ *  Each index is written by one side only and sits on its own cache line; each side also keeps a
+ *  copy of the other side's index, and only reads the shared one when the copy says full or empty.
+ *
+ *  Only one thread may push and only one thread may pop, for the lifetime of the queue or until
+ *  both synchronize by other means.
+ */
+template< typename T >
+class SpscQueue : public NonCopyable
+{
+public:
+    /**
+     * @brief Class constructor.
+     * @param [in] capacity the number of elements the queue can hold, rounded up to a power of two.
+     */
+    explicit SpscQueue(std::size_t capacity){
+        std::size_t size = 2;
+        while ( size < capacity + 1 ) size *= 2;
+        _slots.resize(size);
+        _mask = size - 1;
+    }
+    /**
+     * @brief The number of elements the queue can hold.
+     */
+    std::size_t capacity() const noexcept { return _mask; }
+    /**
+     * @brief Copies an element at the end of the queue. Producer only.
+     * @return false, and nothing is copied, if the queue is full.
+     */
+    bool try_push(const T& value){
+        const std::size_t tail = _tail.load(std::memory_order_relaxed);
+        const std::size_t next = ( tail + 1 ) & _mask;
+        if ( next == _head_copy ){
+            _head_copy = _head.load(std::memory_order_acquire);
+            if ( next == _head_copy ) return false;
+        }
+        _slots[tail] = value;
+        _tail.store(next, std::memory_order_release);
+        return true;
+    }
+    /**
+     * @brief Swaps the first element of the queue with value. Consumer only.
+     * @return false, and value is unchanged, if the queue is empty.
+     */
+    bool try_pop(T& value){
+        using std::swap;
+        const std::size_t head = _head.load(std::memory_order_relaxed);
+        if ( head == _tail_copy ){
+            _tail_copy = _tail.load(std::memory_order_acquire);
+            if ( head == _tail_copy ) return false;
+        }
+        swap( value, _slots[head] );
+        _head.store( ( head + 1 ) & _mask, std::memory_order_release );
+        return true;
+    }
+
+private:
+
+    // padding rather than alignas: the queues are allocated with new, which ignores extended alignments before C++17
+    static constexpr std::size_t line = 64;
+
+    std::vector<T>           _slots;
+    std::size_t              _mask = 1;
+    char                     _pad0[line];
+    std::atomic<std::size_t> _head{0};  // written by the consumer
+    std::size_t              _tail_copy = 0;
+    char                     _pad1[line - sizeof(std::size_t) * 2];
+    std::atomic<std::size_t> _tail{0};  // written by the producer
+    std::size_t              _head_copy = 0;
+    char                     _pad2[line - sizeof(std::size_t) * 2];
+};
+
+}
+
+#endif // SPSCQUEUE_HPP
@@ -0,0 +1,233 @@
+/** @file onion/ThreadPool.hpp
+ *  @brief Contains the definition of the ThreadPool class.
+ *  <hr>
+ *  @copyright 2022 André Ladeira / Onion Framework.
+ */
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include "NonCopyable.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace onion{
+
+/** @class ThreadPool
+ *  @brief A fixed set of threads that run the iterations of parallel loops.
+ *
+ *  The threads are created once, by the constructor, and sleep between loops. A generational algorithm
+ *  that evaluates its population on every generation (see ParallelObjective) then pays for a wake-up
+ *  per loop instead of a thread creation per loop and per thread.
+ *
+ *  parallel_for() splits the indices [0, n) into blocks of consecutive indices, handed out on demand to the
+ *  threads of the pool and to the calling thread, which takes part in the loop. It returns when every block
+ *  is done.
+ *
+ *  for_each_thread() calls a function once on each thread of the pool, concurrently: the calls may wait for
+ *  each other (a barrier, for example), which the blocks of a parallel_for() must not do.
+ *
+ *  Loops submitted from several threads run one after the other. A loop body must not submit a loop to
+ *  the same pool.
+ */
+class ThreadPool : public NonCopyable
+{
+public:
+    /**
+     * @brief Class constructor.
+     * @param [in] num_threads the number of threads that run a loop, the calling thread included.
+     *             0 means one per hardware thread.
+     *
+     * The pool creates num_threads - 1 threads.
+     */
+    explicit ThreadPool(unsigned int num_threads = 0){
+        if ( !num_threads ) num_threads = std::max( 1u, std::thread::hardware_concurrency() );
+        _workers.reserve(num_threads - 1);
+        for (unsigned int t = 1; t < num_threads; ++t) _workers.emplace_back( [this, t](){ work(t); } );
+    }
+    /**
+     * @brief Class destructor. Waits for the threads of the pool to stop.
+     */
+    ~ThreadPool(){
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (auto& t : _workers) t.join();
+    }
+    /**
+     * @brief The number of threads that run a loop, the calling thread included.
+     */
+    unsigned int size() const noexcept { return static_cast<unsigned int>( _workers.size() ) + 1; }
+    /**
+     * @brief Calls f(first, last) on blocks of consecutive indices that cover [0, n).
+     * @param [in] n the number of indices.
+     * @param [in] f the loop body. It is called concurrently on disjoint blocks: it must only write
+     *             to data owned by its block.
+     *
+     * If f throws, the remaining blocks are skipped and the first exception is rethrown
+     * once every thread has stopped.
+     */
+    template< typename function_t >
+    void parallel_for(std::size_t n, function_t f){
+        if ( _workers.empty() || n < 2 ){
+            if ( n ) f(std::size_t(0), n);
+            return;
+        }
+        std::lock_guard<std::mutex> submit(_submit_mutex);
+        _each  = false;
+        _n     = n;
+        // about 16 blocks per thread: few enough to keep the counter cold, enough to balance uneven blocks
+        _block = std::max<std::size_t>( 1, n / ( 16 * std::size_t( size() ) ) );
+        execute(f);
+    }
+    /**
+     * @brief Calls f(thread) once on each thread of the pool, thread = 0 .. size() - 1.
+     * @param [in] f the function. The calling thread runs f(0).
+     *
+     * The calls run concurrently, so they may synchronize with each other.
+     * If some call throws, the first exception is rethrown once every call has returned:
+     * a call must not throw while the others wait for it.
+     */
+    template< typename function_t >
+    void for_each_thread(function_t f){
+        std::lock_guard<std::mutex> submit(_submit_mutex);
+        _each = true;
+        auto call = [&f](std::size_t thread, std::size_t){ f( static_cast<unsigned int>(thread) ); };
+        execute(call);
+    }
+
+private:
+
+    template< typename function_t >
+    void execute(function_t& f){
+        _body  = &f;
+        _run   = [](void* body, std::size_t first, std::size_t last){ ( *static_cast<function_t*>(body) )(first, last); };
+        _next.store(0);
+        _failed.store(false);
+        _error = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _busy = static_cast<unsigned int>( _workers.size() );
+            ++_generation;
+        }
+        _wake.notify_all();
+
+        run(0);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait( lock, [this](){ return _busy == 0; } );
+        if ( _error ) std::rethrow_exception(_error);
+    }
+
+    // thread t's share of the current job
+    void run(unsigned int t) noexcept {
+        if ( !_each ){
+            run_blocks();
+            return;
+        }
+        try{
+            _run( _body, t, t + 1 );
+        }
+        catch (...){
+            std::lock_guard<std::mutex> lock(_error_mutex);
+            if ( !_error ) _error = std::current_exception();
+            _failed = true;
+        }
+    }
+
+    void run_blocks() noexcept {
+        try{
+            for (std::size_t first = _next.fetch_add(_block); first < _n && !_failed.load(std::memory_order_relaxed);
+                 first = _next.fetch_add(_block)){
+                _run( _body, first, std::min(first + _block, _n) );
+            }
+        }
+        catch (...){
+            std::lock_guard<std::mutex> lock(_error_mutex);
+            if ( !_error ) _error = std::current_exception();
+            _failed = true;
+        }
+    }
+
+    void work(unsigned int t){
+        std::size_t seen = 0;
+        for (;;){
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait( lock, [&](){ return _stop || _generation != seen; } );
+                if ( _stop ) return;
+                seen = _generation;
+            }
+            run(t);
+            std::lock_guard<std::mutex> lock(_mutex);
+            if ( --_busy == 0 ) _done.notify_one();
+        }
+    }
+
+    std::vector<std::thread> _workers;
+    std::mutex               _submit_mutex;
+    std::mutex               _mutex;
+    std::condition_variable  _wake;
+    std::condition_variable  _done;
+    std::size_t              _generation = 0;
+    unsigned int             _busy       = 0;
+    bool                     _stop       = false;
+
+    // the current job: a loop, or one call per thread (_each)
+    bool                     _each = false;
+    void*                    _body = nullptr;
+    void                   (*_run)(void*, std::size_t, std::size_t) = nullptr;
+    std::size_t              _n     = 0;
+    std::size_t              _block = 1;
+    std::atomic<std::size_t> _next{0};
+    std::atomic<bool>        _failed{false};
+    std::exception_ptr       _error;
+    std::mutex               _error_mutex;
+};
+
+/** @class SpinBarrier
+ *  @brief Barrier for a fixed number of threads that wait by spinning, without locks.
+ *
+ *  Made for the calls of ThreadPool::for_each_thread() that advance in rounds: each thread calls wait() at
+ *  the end of a round and leaves it when every thread has arrived. Everything a thread wrote before its
+ *  wait() is visible to the others after theirs. A waiting thread yields its core between checks, so
+ *  rounds should be long compared to a scheduler time slice when there are more threads than cores.
+ */
+class SpinBarrier : public NonCopyable
+{
+public:
+    /**
+     * @brief Class constructor.
+     * @param [in] num_threads the number of threads that meet at the barrier.
+     */
+    explicit SpinBarrier(unsigned int num_threads) noexcept : _num_threads(num_threads) {}
+    /**
+     * @brief Waits until num_threads threads have called wait(). The barrier can be reused at once.
+     */
+    void wait() noexcept {
+        const unsigned int round = _round.load(std::memory_order_acquire);
+        if ( _arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == _num_threads ){
+            _arrived.store(0, std::memory_order_relaxed);
+            _round.store(round + 1, std::memory_order_release);
+            return;
+        }
+        while ( _round.load(std::memory_order_acquire) == round ) std::this_thread::yield();
+    }
+
+private:
+
+    const unsigned int        _num_threads;
+    std::atomic<unsigned int> _arrived{0};
+    std::atomic<unsigned int> _round{0};
+};
+
+}
+
+#endif // THREADPOOL_HPP
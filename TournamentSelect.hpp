@@ -0,0 +1,77 @@
+/** @file onion/TournamentSelect.hpp
+ *  @brief Contains the definition of the TournamentSelect class.
+ *  <hr>
+ *  @copyright 2022 André Ladeira / Onion Framework.
+ */
+#ifndef TOURNAMENTSELECT_HPP
+#define TOURNAMENTSELECT_HPP
+
+#include "ComparissonOperator.hpp"
+#include "Random.hpp"
+#include "SelectOperator.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace onion{
+
+/** @class TournamentSelect
+ *  @brief Tournament selection: the best of k candidates drawn uniformly, with replacement.
+ *  @param objective_value_t the type used to represent the value of a solution.
+ *  @param compare the comparisson that defines the better of two values: Less to minimize, Greater to maximize.
+ *
+ *  k sets the selection pressure: 1 is a uniform choice, 2 the usual binary tournament, n or more
+ *  almost always picks the best. The cost is k calls to Random(), whatever the number of candidates.
+ *  select() keeps no state: it can be called concurrently by threads that each have their own engine.
+ *  operator() stores its choice for selected(), so only select() is safe on a shared instance.
+ */
+template< typename objective_value_t, ComparissonOperator<objective_value_t> compare = Less<objective_value_t> >
+class TournamentSelect : public SelectOperator< objective_value_t, std::vector<objective_value_t>, compare >
+{
+public:
+    /**
+     * @brief Class constructor.
+     * @param [in] k the size of the tournament, at least 1.
+     */
+    explicit TournamentSelect(unsigned int k = 2):
+        ComponentID( IDBuilder()
+                    .name("TournamentSelect")
+                    .description("Best of k candidates drawn uniformly.")
+                    .type("Select Operator")
+                    .version("v0.1.0")),
+        _k( k ? k : 1 ){
+    }
+    /**
+     * @brief Chooses among the candidates; the choice is returned by selected().
+     */
+    virtual void operator()(const objective_value_t&, const std::vector<objective_value_t>& candidates){
+        _selected = candidates.empty() ? 0 : select( candidates.data(), candidates.size() );
+    }
+
+    virtual std::size_t select(const objective_value_t* values, std::size_t n){
+        return tournament(values, n, _k);
+    }
+    /**
+     * @brief The position of the candidate chosen by the last operator() call.
+     */
+    std::size_t selected() const noexcept { return _selected; }
+
+    static inline std::size_t tournament(const objective_value_t* values, std::size_t n, unsigned int k){
+        auto& rng = Random();
+        const unsigned int last = static_cast<unsigned int>(n - 1);
+        std::size_t winner = rng.uniform_int_between(0, last);
+        for (unsigned int i = 1; i < k; ++i){
+            const std::size_t c = rng.uniform_int_between(0, last);
+            if ( compare( values[c], values[winner] ) ) winner = c;
+        }
+        return winner;
+    }
+
+private:
+
+    unsigned int _k;
+    std::size_t  _selected = 0;
+};
+
+}
+
+#endif // TOURNAMENTSELECT_HPP
@@ -23,6 +23,12 @@ constexpr bool has_subscript_operator = false;
 template <typename T>
 constexpr bool has_subscript_operator<T, void_t< decltype(std::declval<T>()[0])>> = true;
 
+template <typename, typename = void>
+constexpr bool has_binary_call_operator = false;
+
+template <typename T>
+constexpr bool has_binary_call_operator<T, void_t< decltype(std::declval<T>()(0u,0u))>> = true;
+
 
 }
 
@@ -0,0 +1,142 @@
+/** @file onion/bench/random_bench.cpp
+ *  @brief Microbenchmark of the random number conversions and engines.
+ *
+ *  Times 10 million draws of each kind and prints the time in seconds.
+ *
+ *  - Conversions: the words of a std::mt19937 mapped to [1,1000] and to [0,1) by the conversions of
+ *    RandomDistributions.hpp, by the STL distributions and, for reference, by the biased `x % range`.
+ *    Then the engines that use them, through the RandomEngine interface.
+ *  - Engines: RandomXoshiro256, with single draws and with the fill_* methods, relative to
+ *    RandomSTL<std::minstd_rand>. These are the figures of the table in the RandomXoshiro256 documentation.
+ *
+ *  Build and run, from the directory that contains the framework as onion/:
+ *
+ *      g++ -std=c++14 -O2 -mavx2 -I. onion/bench/random_bench.cpp -o random_bench && ./random_bench
+ *
+ *  <hr>
+ *  @copyright 2022 André Ladeira / Onion Framework.
+ */
+#include "onion/RandomDistributions.hpp"
+#include "onion/RandomLegacyC.hpp"
+#include "onion/RandomSTL.hpp"
+#include "onion/RandomXoshiro.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace onion;
+
+namespace {
+
+const std::size_t draws = 10000000;
+
+// the sum of the draws is printed, so that they are not optimized away
+double sink = 0;
+
+// seconds taken by draws calls to draw()
+template< typename draw_t >
+double seconds(draw_t&& draw){
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    double sum = 0;
+    for (std::size_t k = 0; k < draws; ++k) sum += draw();
+    const double s = std::chrono::duration<double>( clock::now() - start ).count();
+    sink += sum;
+    return s;
+}
+
+void row(const char* name, double s){
+    std::printf( "  %-52s %8.3f s\n", name, s );
+}
+
+void conversions(){
+    std::printf( "Conversions of std::mt19937 words, %zu draws\n", draws );
+    std::mt19937 words(1);
+    auto next = [&words](){ return static_cast<std::uint32_t>( words() ); };
+
+    std::uniform_int_distribution<std::uint32_t> uniform_int(1, 1000);
+    row( "[1,1000]  bounded_int",                    seconds( [&](){ return 1 + bounded_int(1000, next); } ) );
+    row( "[1,1000]  std::uniform_int_distribution",  seconds( [&](){ return uniform_int(words); } ) );
+    row( "[1,1000]  x % range (biased)",             seconds( [&](){ return 1 + next() % 1000; } ) );
+
+    std::uniform_real_distribution<double> uniform_real(0.0, 1.0);
+    row( "[0,1)     real_01 (two words)",            seconds( [&](){ const std::uint32_t h = next(); return real_01( h, next() ); } ) );
+    row( "[0,1)     std::generate_canonical<53>",    seconds( [&](){ return std::generate_canonical<double, 53>(words); } ) );
+    row( "[0,1)     std::uniform_real_distribution", seconds( [&](){ return uniform_real(words); } ) );
+
+    std::printf( "Engines, through the RandomEngine interface\n" );
+    RandomSTL<std::mt19937> mt;
+    RandomSTL<>             lcg;
+    RandomLegacyC           legacy;
+    RandomEngine* engines[]      = { &mt, &lcg, &legacy };
+    const char*   engine_names[] = { "RandomSTL<mt19937>", "RandomSTL<minstd_rand>", "RandomLegacyC" };
+    for (std::size_t e = 0; e < 3; ++e){
+        RandomEngine& rng = *engines[e];
+        char name[64];
+        std::snprintf( name, sizeof(name), "[1,1000]  %s", engine_names[e] );
+        row( name, seconds( [&](){ return rng.uniform_int_between(1, 1000); } ) );
+        std::snprintf( name, sizeof(name), "[0,1)     %s", engine_names[e] );
+        row( name, seconds( [&](){ return rng.uniform_real_01(); } ) );
+    }
+}
+
+// seconds taken by draws values written by fill(block, n), in blocks of 4096
+template< typename value_t, typename fill_t >
+double block_seconds(fill_t&& fill){
+    using clock = std::chrono::steady_clock;
+    std::vector<value_t> block(4096);
+    const auto start = clock::now();
+    double sum = 0;
+    for (std::size_t k = 0; k < draws; k += block.size()){
+        fill( block.data(), block.size() );
+        for (auto v : block) sum += v;
+    }
+    const double s = std::chrono::duration<double>( clock::now() - start ).count();
+    sink += sum;
+    return s;
+}
+
+void engines(){
+    using int_t  = RandomEngine::int_t;
+    using real_t = RandomEngine::real_t;
+
+    RandomSTL<>      lcg;
+    RandomXoshiro256 xoshiro;
+    RandomEngine&    reference = lcg;
+    RandomEngine&    rng       = xoshiro;
+
+    const double ref[] = {
+        seconds( [&](){ return reference.uniform_int(); } ),
+        seconds( [&](){ return reference.uniform_int_between(1, 1000); } ),
+        seconds( [&](){ return reference.uniform_real_01(); } ),
+    };
+    const double single[] = {
+        seconds( [&](){ return rng.uniform_int(); } ),
+        seconds( [&](){ return rng.uniform_int_between(1, 1000); } ),
+        seconds( [&](){ return rng.uniform_real_01(); } ),
+    };
+    const double fill[] = {
+        block_seconds<int_t>(  [&](int_t* out, std::size_t n){ rng.fill_uniform_int(out, n); } ),
+        block_seconds<int_t>(  [&](int_t* out, std::size_t n){ rng.fill_uniform_int_between(out, n, 1, 1000); } ),
+        block_seconds<real_t>( [&](real_t* out, std::size_t n){ rng.fill_uniform_real_01(out, n); } ),
+    };
+    const char* tests[] = { "integers in [0,max_int]", "integers in [1,1000]", "real numbers in [0,1)" };
+
+    std::printf( "Engines, time relative to RandomSTL<minstd_rand>, %zu draws\n", draws );
+    std::printf( "  %-26s %-18s %-24s %s\n", "test", "RandomSTL (LCG)", "Xoshiro, single draws", "Xoshiro, fill_*" );
+    for (std::size_t t = 0; t < 3; ++t){
+        char reference_time[32];
+        std::snprintf( reference_time, sizeof(reference_time), "1.00 (%.3f s)", ref[t] );
+        std::printf( "  %-26s %-18s %-24.2f %.2f\n", tests[t], reference_time, single[t] / ref[t], fill[t] / ref[t] );
+    }
+}
+
+}
+
+int main(){
+    conversions();
+    engines();
+    std::printf( "(checksum %g)\n", sink );
+}
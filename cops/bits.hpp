@@ -0,0 +1,106 @@
+#ifndef COPS_BITS_HPP
+#define COPS_BITS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace onion{
+namespace cops {
+
+// Word-parallel kernels on bit arrays stored in 64-bit words (bit k of an array is bit k % 64 of word k / 64),
+// shared by the bitset representations (see tsp/bitmatrix/tsp.hpp).
+//
+// popcount counts the bits of an array, popcount_and and popcount_xor those of the AND and XOR of two arrays
+// without storing them. With AVX2 they process 256 bits at a time: bytes are counted with two 16-entry lookups
+// (vpshufb) and summed with vpsadbw (Mula, Kurz and Lemire, "Faster population counts using AVX2
+// instructions"). Otherwise they use the POPCNT instruction when the compiler targets it, or a bit-slicing
+// count.
+
+inline unsigned int popcount(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned int>( __builtin_popcountll(x) );
+#else
+    x = x - ( ( x >> 1 ) & 0x5555555555555555ull );
+    x = ( x & 0x3333333333333333ull ) + ( ( x >> 2 ) & 0x3333333333333333ull );
+    x = ( x + ( x >> 4 ) ) & 0x0f0f0f0f0f0f0f0full;
+    return static_cast<unsigned int>( ( x * 0x0101010101010101ull ) >> 56 );
+#endif
+}
+
+// index of the lowest set bit of x, which must not be 0
+inline unsigned int lowest_bit(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned int>( __builtin_ctzll(x) );
+#else
+    return popcount( ( x & ( ~x + 1 ) ) - 1 );
+#endif
+}
+
+namespace detail{
+
+struct first_word{
+    std::uint64_t operator()(std::uint64_t a, std::uint64_t) const noexcept { return a; }
+#if defined(__AVX2__)
+    __m256i operator()(__m256i a, __m256i) const noexcept { return a; }
+#endif
+};
+
+struct and_words{
+    std::uint64_t operator()(std::uint64_t a, std::uint64_t b) const noexcept { return a & b; }
+#if defined(__AVX2__)
+    __m256i operator()(__m256i a, __m256i b) const noexcept { return _mm256_and_si256(a, b); }
+#endif
+};
+
+struct xor_words{
+    std::uint64_t operator()(std::uint64_t a, std::uint64_t b) const noexcept { return a ^ b; }
+#if defined(__AVX2__)
+    __m256i operator()(__m256i a, __m256i b) const noexcept { return _mm256_xor_si256(a, b); }
+#endif
+};
+
+template< typename operation_t >
+inline std::size_t popcount(const std::uint64_t* a, const std::uint64_t* b, std::size_t words, operation_t op) noexcept {
+    std::size_t count = 0;
+    std::size_t k = 0;
+#if defined(__AVX2__)
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    __m256i sum = _mm256_setzero_si256();
+    for (; k + 4 <= words; k += 4){
+        const __m256i v  = op( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( a + k ) ),
+                               _mm256_loadu_si256( reinterpret_cast<const __m256i*>( b + k ) ) );
+        const __m256i lo = _mm256_shuffle_epi8( table, _mm256_and_si256(v, nibble) );
+        const __m256i hi = _mm256_shuffle_epi8( table, _mm256_and_si256( _mm256_srli_epi16(v, 4), nibble ) );
+        sum = _mm256_add_epi64( sum, _mm256_sad_epu8( _mm256_add_epi8(lo, hi), _mm256_setzero_si256() ) );
+    }
+    count = static_cast<std::size_t>( _mm256_extract_epi64(sum, 0) + _mm256_extract_epi64(sum, 1) +
+                                      _mm256_extract_epi64(sum, 2) + _mm256_extract_epi64(sum, 3) );
+#endif
+    for (; k < words; ++k) count += cops::popcount( op(a[k], b[k]) );
+    return count;
+}
+
+}
+
+inline std::size_t popcount(const std::uint64_t* a, std::size_t words) noexcept {
+    return detail::popcount(a, a, words, detail::first_word());
+}
+
+inline std::size_t popcount_and(const std::uint64_t* a, const std::uint64_t* b, std::size_t words) noexcept {
+    return detail::popcount(a, b, words, detail::and_words());
+}
+
+inline std::size_t popcount_xor(const std::uint64_t* a, const std::uint64_t* b, std::size_t words) noexcept {
+    return detail::popcount(a, b, words, detail::xor_words());
+}
+
+}
+}
+
+#endif // COPS_BITS_HPP
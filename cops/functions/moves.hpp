@@ -0,0 +1,126 @@
+#ifndef FUNCTIONS_MOVES_HPP
+#define FUNCTIONS_MOVES_HPP
+
+#include "population.hpp"
+#include "onion/DeltaObjective.hpp"
+#include "onion/MoveOperator.hpp"
+#include "onion/ParameterOperator.hpp"
+#include "onion/Random.hpp"
+#include <string>
+
+namespace onion{
+namespace cops {
+namespace functions {
+
+// Coordinate moves on points of R^n, for the delta-driven algorithms (LocalSearch, SimulatedAnnealing):
+//
+// RandomCoordinate : draws a coordinate d uniformly and a step uniformly in [-radius, radius]
+// DeltaCoordinate  : f(x + step e_d) - f(x) for a kernel of rv_functions.hpp (its delta())
+// CoordinateMove   : x[d] += step, in place. The undo token is the opposite step
+//
+// The box [lower, upper]^n is not enforced: penalize, or pick a radius small against the box.
+// Summing deltas accumulates rounding errors: evaluate the point again when the exact value matters.
+//
+// point_type is any container of doubles with data(), size() and operator[], point_t by default.
+// RandomCoordinate draws from the engine given to its constructor, if any, or from onion::Random(): see
+// the engine_t notes of ../tsp/array/parameter_operator.hpp.
+
+// Moves coordinate d by step.
+struct coordinate_t{
+    unsigned int d;
+    double       step;
+};
+
+template< typename point_type = point_t, typename engine_t = onion::RandomEngine >
+class RandomCoordinate : public onion::ParameterOperator< point_type, coordinate_t >
+{
+public:
+
+    RandomCoordinate(unsigned int dimension, double radius, engine_t* engine = nullptr):
+        ComponentID( IDBuilder()
+                    .name("RandomCoordinate")
+                    .description("Draws a random step along a random coordinate.")
+                    .type("Parameter Operator")
+                    .version("v0.1.0")
+                    .problem("Real-valued")),
+        _dimension(dimension),
+        _radius(radius),
+        _engine(engine){
+    }
+
+    virtual coordinate_t operator()(){
+        return _engine ? draw(*_engine) : draw( onion::Random() );
+    }
+
+    template< typename rng_t >
+    coordinate_t draw(rng_t& rng) const noexcept {
+        const unsigned int d = rng.uniform_int_between(0, _dimension - 1);
+        return coordinate_t{ d, _radius * ( 2 * rng.uniform_real_01() - 1 ) };
+    }
+
+    double radius() const noexcept { return _radius; }
+    void   radius(double r) noexcept { _radius = r; }
+
+private:
+
+    unsigned int _dimension;
+    double       _radius;
+    engine_t*    _engine;
+};
+
+template< typename kernel_t, typename point_type = point_t >
+class DeltaCoordinate : public onion::DeltaObjective< point_type, coordinate_t, double >
+{
+public:
+
+    DeltaCoordinate():
+        ComponentID( IDBuilder()
+                    .name( std::string("Delta") + kernel_t::name() )
+                    .description("Variation of a benchmark function caused by a coordinate move.")
+                    .type("Delta Objective")
+                    .version("v0.1.0")
+                    .problem("Real-valued")){
+    }
+
+    virtual double operator()(const point_type& x, const coordinate_t& m){
+        return delta(x, m);
+    }
+
+    static inline double delta(const point_type& x, const coordinate_t& m) noexcept {
+        return kernel_t::delta( x.data(), static_cast<unsigned int>( x.size() ), m.d, m.step );
+    }
+};
+
+template< typename point_type = point_t >
+class CoordinateMove : public onion::MoveOperator< point_type, coordinate_t >
+{
+public:
+
+    CoordinateMove():
+        ComponentID( IDBuilder()
+                    .name("CoordinateMove")
+                    .description("Moves a point along a coordinate in place.")
+                    .type("Move Operator")
+                    .version("v0.1.0")
+                    .problem("Real-valued")){
+    }
+
+    virtual coordinate_t apply(point_type& x, const coordinate_t& m){
+        return move(x, m);
+    }
+
+    virtual void undo(point_type& x, const coordinate_t& u){
+        move(x, u);
+    }
+
+    static inline coordinate_t move(point_type& x, const coordinate_t& m) noexcept {
+        x[m.d] += m.step;
+        return coordinate_t{ m.d, -m.step };
+    }
+};
+
+}
+}
+}
+
+#endif // FUNCTIONS_MOVES_HPP
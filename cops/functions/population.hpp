@@ -0,0 +1,69 @@
+#ifndef FUNCTIONS_POPULATION_HPP
+#define FUNCTIONS_POPULATION_HPP
+
+#include "onion/AlignedAllocator.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace functions {
+
+using point_t = std::vector<double>;
+
+// Points of R^n stored coordinate by coordinate (structure of arrays): row d holds coordinate d of every
+// point, so x(d, k) = data[ d * stride() + k ]. The batch kernels of rv_functions.hpp load the same
+// coordinate of consecutive points into the lanes of a SIMD register, and evaluate one point per lane.
+//
+// Rows are padded with zeros to stride(), a multiple of 8 (one cache line of doubles), and start on a
+// 64-byte boundary. The padding lanes are evaluated with the others, and their values discarded.
+
+class Population{
+public:
+
+    Population() = default;
+
+    Population(unsigned int dimension, std::size_t size){
+        resize(dimension, size);
+    }
+
+    // all coordinates are reset to 0; the storage is reused when large enough
+    void resize(unsigned int dimension, std::size_t size){
+        _dimension = dimension;
+        _size      = size;
+        _stride    = ( size + 7 ) / 8 * 8;
+        _data.assign( std::size_t(dimension) * _stride, 0.0 );
+    }
+
+    unsigned int dimension() const noexcept { return _dimension; }
+    std::size_t  size()      const noexcept { return _size; }
+    std::size_t  stride()    const noexcept { return _stride; }
+
+    double&       operator()(unsigned int d, std::size_t k)       noexcept { return _data[ d * _stride + k ]; }
+    const double& operator()(unsigned int d, std::size_t k) const noexcept { return _data[ d * _stride + k ]; }
+
+    double*       row(unsigned int d)       noexcept { return _data.data() + d * _stride; }
+    const double* row(unsigned int d) const noexcept { return _data.data() + d * _stride; }
+
+    // copies point k from, or into, dimension() contiguous values
+    void set(std::size_t k, const double* x) noexcept {
+        for (unsigned int d = 0; d < _dimension; ++d) _data[ d * _stride + k ] = x[d];
+    }
+
+    void get(std::size_t k, double* x) const noexcept {
+        for (unsigned int d = 0; d < _dimension; ++d) x[d] = _data[ d * _stride + k ];
+    }
+
+private:
+
+    unsigned int _dimension = 0;
+    std::size_t  _size      = 0;
+    std::size_t  _stride    = 0;
+    std::vector< double, onion::AlignedAllocator<double> > _data;
+};
+
+}
+}
+}
+
+#endif // FUNCTIONS_POPULATION_HPP
@@ -1 +1,408 @@
-//placeholder
+#ifndef RV_FUNCTIONS_HPP
+#define RV_FUNCTIONS_HPP
+
+#include "population.hpp"
+#include "vec.hpp"
+#include "onion/ObjectiveFunction.hpp"
+#include "onion/Random.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace functions {
+
+// Real-valued benchmark functions, to minimize over a box [lower(), upper()]^n. All have their minimum 0 at the
+// point with every coordinate equal to origin():
+//
+// Sphere     : sum x_i^2                                                                [-100, 100]
+// Rastrigin  : 10 n + sum ( x_i^2 - 10 cos(2 pi x_i) )                                  [-5.12, 5.12]
+// Rosenbrock : sum_{i < n-1} 100 ( x_{i+1} - x_i^2 )^2 + ( x_i - 1 )^2     origin 1     [-30, 30]
+// Ackley     : 20 + e - 20 exp( -0.2 sqrt( sum x_i^2 / n ) ) - exp( sum cos(2 pi x_i) / n )  [-32.768, 32.768]
+// Griewank   : 1 + sum x_i^2 / 4000 - prod cos( x_i / sqrt(i+1) )                       [-600, 600]
+// Schwefel   : 418.9828872724339 n - sum x_i sin( sqrt(|x_i|) )       origin 420.9687   [-500, 500]
+//                                                                     (the value there is 0 to 1e-11 n)
+//
+// Each function is a kernel, written once over the lanes of vec.hpp, and wrapped by:
+//
+// - Function<kernel>    : the plain function. One point (operator()) or a Population (evaluate(), one point
+//                         per SIMD lane)
+// - Transformed<kernel> : CEC-style shifted and rotated variant F(x) = f( M (x - o) + origin ) + bias, so the
+//                         minimum bias is at x = o. M is an orthogonal matrix (random_rotation()), the
+//                         identity when omitted
+//
+// Each kernel also gives the variation of f when one coordinate moves, delta(): O(1) for the separable
+// functions and Rosenbrock, O(n) for Ackley and Griewank (see moves.hpp).
+//
+// Both also evaluate arrays of points (ObjectiveFunction::evaluate()): the points are copied into a
+// Population, 64 at a time, and evaluated in batch. Function is safe to call from several threads, so it can
+// be wrapped by a ParallelObjective; Transformed only through this array form.
+//
+// point_type is any container of doubles with data() and size(), point_t by default. n >= 1 (Rosenbrock:
+// n >= 2). The batch values may differ from the single ones in the last bits: sin and cos are computed by
+// the polynomials of vec.hpp instead of <cmath>.
+
+namespace detail{
+
+constexpr double two_pi = 6.28318530717958647693;
+
+// f(p, values + first) on the points [first, first + p.size()) copied into p, 64 points at a time
+template< typename point_type, typename function_t >
+inline void evaluate_packed(const point_type* points, double* values, std::size_t n, function_t f){
+    if ( !n ) return;
+    const unsigned int dimension = static_cast<unsigned int>( points[0].size() );
+    Population p( dimension, std::min<std::size_t>(n, 64) );
+    for (std::size_t first = 0; first < n; first += 64){
+        const std::size_t count = std::min<std::size_t>(n - first, 64);
+        if ( count != p.size() ) p.resize(dimension, count);
+        for (std::size_t k = 0; k < count; ++k) p.set( k, points[first + k].data() );
+        f( p, values + first );
+    }
+}
+
+}
+
+struct Sphere{
+    static const char* name() noexcept { return "Sphere"; }
+    static constexpr double lower()  noexcept { return -100; }
+    static constexpr double upper()  noexcept { return 100; }
+    static constexpr double origin() noexcept { return 0; }
+
+    // coordinate d of the points at x + d * stride
+    template< typename V >
+    static V value(const double* x, std::size_t stride, unsigned int n) noexcept {
+        V sum = V::broadcast(0);
+        for (unsigned int d = 0; d < n; ++d){
+            const V xd = V::load( x + d * stride );
+            sum = sum + xd * xd;
+        }
+        return sum;
+    }
+
+    // f(x + step e_d) - f(x)
+    static double delta(const double* x, unsigned int, unsigned int d, double step) noexcept {
+        return step * ( 2 * x[d] + step );
+    }
+};
+
+struct Rastrigin{
+    static const char* name() noexcept { return "Rastrigin"; }
+    static constexpr double lower()  noexcept { return -5.12; }
+    static constexpr double upper()  noexcept { return 5.12; }
+    static constexpr double origin() noexcept { return 0; }
+
+    template< typename V >
+    static V value(const double* x, std::size_t stride, unsigned int n) noexcept {
+        const V two_pi = V::broadcast(detail::two_pi), ten = V::broadcast(10);
+        V sum = V::broadcast( 10.0 * n );
+        for (unsigned int d = 0; d < n; ++d){
+            const V xd = V::load( x + d * stride );
+            sum = sum + xd * xd - ten * cos( two_pi * xd );
+        }
+        return sum;
+    }
+
+    static double delta(const double* x, unsigned int, unsigned int d, double step) noexcept {
+        const double y = x[d] + step;
+        return step * ( x[d] + y ) - 10 * ( std::cos( detail::two_pi * y ) - std::cos( detail::two_pi * x[d] ) );
+    }
+};
+
+struct Rosenbrock{
+    static const char* name() noexcept { return "Rosenbrock"; }
+    static constexpr double lower()  noexcept { return -30; }
+    static constexpr double upper()  noexcept { return 30; }
+    static constexpr double origin() noexcept { return 1; }
+
+    template< typename V >
+    static V value(const double* x, std::size_t stride, unsigned int n) noexcept {
+        const V one = V::broadcast(1), hundred = V::broadcast(100);
+        V sum = V::broadcast(0);
+        V xd  = V::load(x);
+        for (unsigned int d = 1; d < n; ++d){
+            const V next = V::load( x + d * stride );
+            const V a = next - xd * xd, b = xd - one;
+            sum = sum + hundred * a * a + b * b;
+            xd  = next;
+        }
+        return sum;
+    }
+
+    static double delta(const double* x, unsigned int n, unsigned int d, double step) noexcept {
+        const double y = x[d] + step;
+        double change = 0;
+        if ( d > 0 ){
+            const double a = x[d] - x[d-1] * x[d-1], b = y - x[d-1] * x[d-1];
+            change += 100 * ( b * b - a * a );
+        }
+        if ( d + 1 < n ){
+            const double a = x[d+1] - x[d] * x[d], b = x[d+1] - y * y;
+            change += 100 * ( b * b - a * a ) + ( y - 1 ) * ( y - 1 ) - ( x[d] - 1 ) * ( x[d] - 1 );
+        }
+        return change;
+    }
+};
+
+struct Ackley{
+    static const char* name() noexcept { return "Ackley"; }
+    static constexpr double lower()  noexcept { return -32.768; }
+    static constexpr double upper()  noexcept { return 32.768; }
+    static constexpr double origin() noexcept { return 0; }
+
+    template< typename V >
+    static V value(const double* x, std::size_t stride, unsigned int n) noexcept {
+        const V two_pi = V::broadcast(detail::two_pi);
+        V squares = V::broadcast(0), cosines = V::broadcast(0);
+        for (unsigned int d = 0; d < n; ++d){
+            const V xd = V::load( x + d * stride );
+            squares = squares + xd * xd;
+            cosines = cosines + cos( two_pi * xd );
+        }
+        const V inv_n = V::broadcast( 1.0 / n );
+        return V::broadcast( 20.0 + 2.71828182845904523536 )
+             - V::broadcast(20) * exp( V::broadcast(-0.2) * sqrt( squares * inv_n ) )
+             - exp( cosines * inv_n );
+    }
+
+    // O(n): both sums are computed again
+    static double delta(const double* x, unsigned int n, unsigned int d, double step) noexcept {
+        double squares = 0, cosines = 0;
+        for (unsigned int e = 0; e < n; ++e){
+            squares += x[e] * x[e];
+            cosines += std::cos( detail::two_pi * x[e] );
+        }
+        const double y = x[d] + step;
+        const double squares_y = squares + step * ( x[d] + y );
+        const double cosines_y = cosines + std::cos( detail::two_pi * y ) - std::cos( detail::two_pi * x[d] );
+        return 20 * ( std::exp( -0.2 * std::sqrt( squares / n ) ) - std::exp( -0.2 * std::sqrt( std::max(squares_y, 0.0) / n ) ) )
+             + std::exp( cosines / n ) - std::exp( cosines_y / n );
+    }
+};
+
+struct Griewank{
+    static const char* name() noexcept { return "Griewank"; }
+    static constexpr double lower()  noexcept { return -600; }
+    static constexpr double upper()  noexcept { return 600; }
+    static constexpr double origin() noexcept { return 0; }
+
+    template< typename V >
+    static V value(const double* x, std::size_t stride, unsigned int n) noexcept {
+        V sum = V::broadcast(0), product = V::broadcast(1);
+        for (unsigned int d = 0; d < n; ++d){
+            const V xd = V::load( x + d * stride );
+            sum     = sum + xd * xd;
+            product = product * cos( xd * V::broadcast( 1.0 / std::sqrt( d + 1.0 ) ) );
+        }
+        return V::broadcast(1) + sum * V::broadcast( 1.0 / 4000 ) - product;
+    }
+
+    // O(n): the product of the other cosines is computed again
+    static double delta(const double* x, unsigned int n, unsigned int d, double step) noexcept {
+        double product = 1;
+        for (unsigned int e = 0; e < n; ++e) if ( e != d ) product *= std::cos( x[e] / std::sqrt( e + 1.0 ) );
+        const double y = x[d] + step, scale = 1 / std::sqrt( d + 1.0 );
+        return step * ( x[d] + y ) / 4000 - product * ( std::cos( y * scale ) - std::cos( x[d] * scale ) );
+    }
+};
+
+struct Schwefel{
+    static const char* name() noexcept { return "Schwefel"; }
+    static constexpr double lower()  noexcept { return -500; }
+    static constexpr double upper()  noexcept { return 500; }
+    static constexpr double origin() noexcept { return 420.9687462275036; }
+
+    template< typename V >
+    static V value(const double* x, std::size_t stride, unsigned int n) noexcept {
+        V sum = V::broadcast(0);
+        for (unsigned int d = 0; d < n; ++d){
+            const V xd = V::load( x + d * stride );
+            sum = sum + xd * sin( sqrt( abs(xd) ) );
+        }
+        return V::broadcast( 418.9828872724339 * n ) - sum;
+    }
+
+    static double delta(const double* x, unsigned int, unsigned int d, double step) noexcept {
+        const double y = x[d] + step;
+        return x[d] * std::sin( std::sqrt( std::fabs(x[d]) ) ) - y * std::sin( std::sqrt( std::fabs(y) ) );
+    }
+};
+
+template< typename kernel_t, typename point_type = point_t >
+class Function : public onion::ObjectiveFunction< point_type, double >
+{
+public:
+
+    Function():
+        ComponentID( IDBuilder()
+                    .name( kernel_t::name() )
+                    .description("Real-valued benchmark function, to minimize.")
+                    .type("Objective Function")
+                    .version("v0.1.0")
+                    .problem("Real-valued")){
+    }
+
+    virtual double operator()(const point_type& x){
+        return value( x.data(), static_cast<unsigned int>( x.size() ) );
+    }
+
+    virtual void evaluate(const point_type* points, double* values, std::size_t n){
+        detail::evaluate_packed( points, values, n, [](const Population& p, double* v){ evaluate_all(p, v); } );
+    }
+
+    // values[k] = f(point k), for the p.size() points of p
+    void evaluate(const Population& p, double* values) const noexcept {
+        evaluate_all(p, values);
+    }
+
+    static inline double value(const double* x, unsigned int n) noexcept {
+        return kernel_t::template value<vec1>(x, 1, n).v;
+    }
+
+    static inline void evaluate_all(const Population& p, double* values) noexcept {
+        for (std::size_t k = 0; k < p.size(); k += batch_vec::width){
+            kernel_t::template value<batch_vec>( p.row(0) + k, p.stride(), p.dimension() ).store( values + k, p.size() - k );
+        }
+    }
+};
+
+template< typename kernel_t, typename point_type = point_t >
+class Transformed : public onion::ObjectiveFunction< point_type, double >
+{
+public:
+
+    // shift: o, n values. rotation: M, n x n values row by row, or none for the identity
+    Transformed(const std::vector<double>& shift, const std::vector<double>& rotation = {}, double bias = 0):
+        ComponentID( IDBuilder()
+                    .name( std::string( rotation.empty() ? "Shifted " : "Shifted Rotated " ) + kernel_t::name() )
+                    .description("Shifted and rotated real-valued benchmark function, to minimize.")
+                    .type("Objective Function")
+                    .version("v0.1.0")
+                    .problem("Real-valued")),
+        _dimension( static_cast<unsigned int>( shift.size() ) ),
+        _rotation(rotation),
+        _offset( shift.size() ),
+        _bias(bias),
+        _z( shift.size() ){
+        if ( !_rotation.empty() && _rotation.size() != shift.size() * shift.size() )
+            throw std::invalid_argument("Transformed: the rotation must be n x n");
+        // z = M (x - o) + origin = M x + offset
+        for (unsigned int d = 0; d < _dimension; ++d){
+            double mo = shift[d];
+            if ( !_rotation.empty() ){
+                mo = 0;
+                for (unsigned int e = 0; e < _dimension; ++e) mo += _rotation[ std::size_t(d) * _dimension + e ] * shift[e];
+            }
+            _offset[d] = kernel_t::origin() - mo;
+        }
+    }
+
+    // not thread safe: the transformed point is kept in the object
+    virtual double operator()(const point_type& x){
+        const double* p = x.data();
+        for (unsigned int d = 0; d < _dimension; ++d){
+            double z = _offset[d];
+            if ( _rotation.empty() ) z += p[d];
+            else{
+                const double* m = _rotation.data() + std::size_t(d) * _dimension;
+                for (unsigned int e = 0; e < _dimension; ++e) z += m[e] * p[e];
+            }
+            _z[d] = z;
+        }
+        return Function<kernel_t, point_type>::value( _z.data(), _dimension ) + _bias;
+    }
+
+    // safe to call from several threads, unlike the other forms
+    virtual void evaluate(const point_type* points, double* values, std::size_t n){
+        Population z;
+        detail::evaluate_packed( points, values, n, [&](const Population& p, double* v){ evaluate(p, z, v); } );
+    }
+
+    // values[k] = F(point k), for the p.size() points of p. Not thread safe, as operator()
+    void evaluate(const Population& p, double* values){
+        evaluate(p, _zs, values);
+    }
+
+    unsigned int dimension() const noexcept { return _dimension; }
+
+private:
+
+    unsigned int        _dimension;
+    std::vector<double> _rotation;
+    std::vector<double> _offset;
+    double              _bias;
+    std::vector<double> _z;
+    Population          _zs;
+
+    void evaluate(const Population& p, Population& zs, double* values) const {
+        if ( zs.dimension() != _dimension || zs.size() != p.size() ) zs.resize( _dimension, p.size() );
+        const std::size_t stride = p.stride();
+        for (unsigned int d = 0; d < _dimension; ++d){
+            double* z = zs.row(d);
+            std::fill( z, z + stride, _offset[d] );
+            if ( _rotation.empty() ){
+                const double* x = p.row(d);
+                for (std::size_t k = 0; k < stride; ++k) z[k] += x[k];
+                continue;
+            }
+            for (unsigned int e = 0; e < _dimension; ++e){
+                const double  m = _rotation[ std::size_t(d) * _dimension + e ];
+                const double* x = p.row(e);
+                for (std::size_t k = 0; k < stride; ++k) z[k] += m * x[k];
+            }
+        }
+        Function<kernel_t, point_type>::evaluate_all(zs, values);
+        for (std::size_t k = 0; k < p.size(); ++k) values[k] += _bias;
+    }
+};
+
+// Random orthogonal n x n matrix, row by row: Gram-Schmidt on rows of standard normal values (Box-Muller
+// on onion::Random()), which makes it uniform over the orthogonal group.
+inline std::vector<double> random_rotation(unsigned int n){
+    auto& rng = onion::Random();
+    auto normal = [&rng](){
+        double u;
+        do u = rng.uniform_real_01(); while ( u <= 0 );
+        return std::sqrt( -2 * std::log(u) ) * std::cos( detail::two_pi * rng.uniform_real_01() );
+    };
+
+    std::vector<double> m( std::size_t(n) * n );
+    for (unsigned int i = 0; i < n; ++i){
+        double* r = m.data() + std::size_t(i) * n;
+        double  norm;
+        do{
+            for (unsigned int e = 0; e < n; ++e) r[e] = normal();
+            for (unsigned int j = 0; j < i; ++j){
+                const double* q = m.data() + std::size_t(j) * n;
+                double dot = 0;
+                for (unsigned int e = 0; e < n; ++e) dot += r[e] * q[e];
+                for (unsigned int e = 0; e < n; ++e) r[e] -= dot * q[e];
+            }
+            norm = 0;
+            for (unsigned int e = 0; e < n; ++e) norm += r[e] * r[e];
+            norm = std::sqrt(norm);
+        } while ( norm < 1e-8 );
+        for (unsigned int e = 0; e < n; ++e) r[e] /= norm;
+    }
+    return m;
+}
+
+// Random shift o, uniform in [lower + margin, upper - margin]^n with margin 20% of the width, so the
+// shifted minimum stays inside the box.
+template< typename kernel_t >
+inline std::vector<double> random_shift(unsigned int n){
+    auto& rng = onion::Random();
+    const double margin = 0.2 * ( kernel_t::upper() - kernel_t::lower() );
+    std::vector<double> o(n);
+    for (auto& x : o) x = kernel_t::lower() + margin + ( kernel_t::upper() - kernel_t::lower() - 2 * margin ) * rng.uniform_real_01();
+    return o;
+}
+
+}
+}
+}
+
+#endif // RV_FUNCTIONS_HPP
@@ -0,0 +1,142 @@
+#ifndef FUNCTIONS_VEC_HPP
+#define FUNCTIONS_VEC_HPP
+
+#include <cmath>
+#include <cstddef>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace onion{
+namespace cops {
+namespace functions {
+
+// Lanes of doubles for the benchmark kernels (see rv_functions.hpp). A kernel is written once against the
+// interface below and instantiated with
+//
+// - vec1 : one double, the math of <cmath>. Evaluates a single point
+// - vec4 : four doubles in an AVX2 register (when the compiler targets AVX2). Evaluates four points at once
+//
+// batch_vec is vec4 when available, vec1 otherwise.
+//
+//     V::width                   number of lanes
+//     V::load(p), V::broadcast(x), v.store(p, count)    count <= width lanes are written
+//     + - * /, sqrt, abs, sin, cos, exp
+//
+// vec4 computes sin and cos with the minimax polynomials of Cephes (Moshier) on [-pi/4, pi/4], after a
+// three-part Cody-Waite reduction by multiples of pi/2: a few ulps for |x| < 2^30. exp has no cheap AVX2
+// form and is computed lane by lane: the kernels call it once per point, not once per coordinate.
+
+struct vec1{
+    static constexpr unsigned int width = 1;
+
+    double v;
+
+    static vec1 load(const double* p) noexcept       { return vec1{ *p }; }
+    static vec1 broadcast(double x) noexcept         { return vec1{ x }; }
+    void store(double* p, std::size_t = 1) const noexcept { *p = v; }
+};
+
+inline vec1 operator+(vec1 a, vec1 b) noexcept { return vec1{ a.v + b.v }; }
+inline vec1 operator-(vec1 a, vec1 b) noexcept { return vec1{ a.v - b.v }; }
+inline vec1 operator*(vec1 a, vec1 b) noexcept { return vec1{ a.v * b.v }; }
+inline vec1 operator/(vec1 a, vec1 b) noexcept { return vec1{ a.v / b.v }; }
+inline vec1 sqrt(vec1 a) noexcept { return vec1{ std::sqrt(a.v) }; }
+inline vec1 abs(vec1 a)  noexcept { return vec1{ std::fabs(a.v) }; }
+inline vec1 sin(vec1 a)  noexcept { return vec1{ std::sin(a.v) }; }
+inline vec1 cos(vec1 a)  noexcept { return vec1{ std::cos(a.v) }; }
+inline vec1 exp(vec1 a)  noexcept { return vec1{ std::exp(a.v) }; }
+
+#if defined(__AVX2__)
+
+struct vec4{
+    static constexpr unsigned int width = 4;
+
+    __m256d v;
+
+    static vec4 load(const double* p) noexcept       { return vec4{ _mm256_loadu_pd(p) }; }
+    static vec4 broadcast(double x) noexcept         { return vec4{ _mm256_set1_pd(x) }; }
+
+    void store(double* p, std::size_t count = width) const noexcept {
+        if ( count >= width ){
+            _mm256_storeu_pd(p, v);
+            return;
+        }
+        alignas(32) double lanes[width];
+        _mm256_store_pd(lanes, v);
+        for (std::size_t k = 0; k < count; ++k) p[k] = lanes[k];
+    }
+};
+
+inline vec4 operator+(vec4 a, vec4 b) noexcept { return vec4{ _mm256_add_pd(a.v, b.v) }; }
+inline vec4 operator-(vec4 a, vec4 b) noexcept { return vec4{ _mm256_sub_pd(a.v, b.v) }; }
+inline vec4 operator*(vec4 a, vec4 b) noexcept { return vec4{ _mm256_mul_pd(a.v, b.v) }; }
+inline vec4 operator/(vec4 a, vec4 b) noexcept { return vec4{ _mm256_div_pd(a.v, b.v) }; }
+inline vec4 sqrt(vec4 a) noexcept { return vec4{ _mm256_sqrt_pd(a.v) }; }
+inline vec4 abs(vec4 a)  noexcept { return vec4{ _mm256_andnot_pd( _mm256_set1_pd(-0.0), a.v ) }; }
+
+namespace detail{
+
+// sin( x + shift * pi/2 ), shift in 0 .. 3
+inline __m256d sin_quadrant(__m256d x, double shift) noexcept {
+    const __m256d q = _mm256_round_pd( _mm256_mul_pd( x, _mm256_set1_pd(0.63661977236758134308) ),   // 2/pi
+                                       _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC );
+    __m256d r = _mm256_sub_pd( x, _mm256_mul_pd( q, _mm256_set1_pd(1.57079625129699707031e+00) ) );
+    r = _mm256_sub_pd( r, _mm256_mul_pd( q, _mm256_set1_pd(7.54978941586159635336e-08) ) );
+    r = _mm256_sub_pd( r, _mm256_mul_pd( q, _mm256_set1_pd(5.39030285815811905290e-15) ) );
+    const __m256d z = _mm256_mul_pd(r, r);
+
+    __m256d ps = _mm256_set1_pd(1.58962301576546568060e-10);
+    ps = _mm256_add_pd( _mm256_mul_pd(ps, z), _mm256_set1_pd(-2.50507477628578072866e-08) );
+    ps = _mm256_add_pd( _mm256_mul_pd(ps, z), _mm256_set1_pd( 2.75573136213857245213e-06) );
+    ps = _mm256_add_pd( _mm256_mul_pd(ps, z), _mm256_set1_pd(-1.98412698295895385996e-04) );
+    ps = _mm256_add_pd( _mm256_mul_pd(ps, z), _mm256_set1_pd( 8.33333333332211858878e-03) );
+    ps = _mm256_add_pd( _mm256_mul_pd(ps, z), _mm256_set1_pd(-1.66666666666666307295e-01) );
+    const __m256d s = _mm256_add_pd( r, _mm256_mul_pd( _mm256_mul_pd(r, z), ps ) );
+
+    __m256d pc = _mm256_set1_pd(-1.13585365213876817300e-11);
+    pc = _mm256_add_pd( _mm256_mul_pd(pc, z), _mm256_set1_pd( 2.08757008419747316778e-09) );
+    pc = _mm256_add_pd( _mm256_mul_pd(pc, z), _mm256_set1_pd(-2.75573141792967388112e-07) );
+    pc = _mm256_add_pd( _mm256_mul_pd(pc, z), _mm256_set1_pd( 2.48015872888517045348e-05) );
+    pc = _mm256_add_pd( _mm256_mul_pd(pc, z), _mm256_set1_pd(-1.38888888888730564116e-03) );
+    pc = _mm256_add_pd( _mm256_mul_pd(pc, z), _mm256_set1_pd( 4.16666666666665929218e-02) );
+    const __m256d c = _mm256_add_pd( _mm256_sub_pd( _mm256_set1_pd(1.0), _mm256_mul_pd( z, _mm256_set1_pd(0.5) ) ),
+                                     _mm256_mul_pd( _mm256_mul_pd(z, z), pc ) );
+
+    // quadrant m = (q + shift) mod 4: sin r, cos r, -sin r, -cos r
+    const __m256d qs = _mm256_add_pd( q, _mm256_set1_pd(shift) );
+    const __m256d m  = _mm256_sub_pd( qs, _mm256_mul_pd( _mm256_set1_pd(4.0),
+                                                         _mm256_floor_pd( _mm256_mul_pd( qs, _mm256_set1_pd(0.25) ) ) ) );
+    const __m256d odd  = _mm256_cmp_pd( _mm256_sub_pd( m, _mm256_mul_pd( _mm256_set1_pd(2.0),
+                                                       _mm256_floor_pd( _mm256_mul_pd( m, _mm256_set1_pd(0.5) ) ) ) ),
+                                        _mm256_set1_pd(1.0), _CMP_EQ_OQ );
+    const __m256d high = _mm256_cmp_pd( m, _mm256_set1_pd(2.0), _CMP_GE_OQ );
+    return _mm256_xor_pd( _mm256_blendv_pd(s, c, odd), _mm256_and_pd( high, _mm256_set1_pd(-0.0) ) );
+}
+
+}
+
+inline vec4 sin(vec4 a) noexcept { return vec4{ detail::sin_quadrant(a.v, 0.0) }; }
+inline vec4 cos(vec4 a) noexcept { return vec4{ detail::sin_quadrant(a.v, 1.0) }; }
+
+inline vec4 exp(vec4 a) noexcept {
+    alignas(32) double lanes[vec4::width];
+    _mm256_store_pd(lanes, a.v);
+    for (auto& x : lanes) x = std::exp(x);
+    return vec4{ _mm256_load_pd(lanes) };
+}
+
+using batch_vec = vec4;
+
+#else
+
+using batch_vec = vec1;
+
+#endif
+
+}
+}
+}
+
+#endif // FUNCTIONS_VEC_HPP
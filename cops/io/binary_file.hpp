@@ -0,0 +1,196 @@
+#ifndef COPS_BINARY_FILE_HPP
+#define COPS_BINARY_FILE_HPP
+
+#include "mapped_file.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace io {
+
+// Versioned binary file made of typed sections, meant to be memory-mapped and used in place.
+//
+// Layout (native byte order):
+//
+//     header   : magic (8 bytes), format version, byte order mark, number of sections, total size
+//     table    : for each section, its id, element size, offset and number of elements
+//     sections : raw arrays, each starting at a multiple of 64 bytes
+//
+// A mapping starts at a page boundary, so every section of a mapped file is aligned to a cache line and can
+// be handed to the operators as it is (see the view constructors of CandidateList, PackedMatrix ...).
+// Files written on a machine with another byte order, by another version or truncated are rejected.
+
+struct binary_header_t{
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint32_t num_sections;
+    std::uint32_t reserved;
+    std::uint64_t size;
+};
+
+struct binary_section_t{
+    std::uint32_t id;
+    std::uint32_t element_size;
+    std::uint64_t offset;
+    std::uint64_t count;
+};
+
+static const std::uint32_t binary_byte_order = 0x01020304;
+static const std::size_t   binary_alignment  = 64;
+
+// magic numbers are up to 8 characters, padded with zeros
+inline void binary_magic(char (&out)[8], const char* magic) noexcept {
+    std::size_t k = 0;
+    for (; k < sizeof(out) && magic[k]; ++k) out[k] = magic[k];
+    for (; k < sizeof(out); ++k) out[k] = 0;
+}
+
+// Collects sections and writes them in a single pass. The arrays are not copied: they must stay alive
+// until write() returns.
+class BinaryWriter{
+public:
+
+    BinaryWriter(const char* magic, std::uint32_t version):
+        _version(version){
+        binary_magic(_magic, magic);
+    }
+
+    template< typename T >
+    void add(std::uint32_t id, const T* data, std::size_t count){
+        _sections.push_back( binary_section_t{ id, static_cast<std::uint32_t>( sizeof(T) ), 0, count } );
+        _data.push_back( data );
+    }
+
+    // Writes to a temporary file and renames it, so that processes opening path concurrently see either
+    // no file or a complete one. Throws std::runtime_error on failure.
+    void write(const std::string& path){
+        binary_header_t header;
+        std::memcpy(header.magic, _magic, sizeof(_magic));
+        header.version      = _version;
+        header.byte_order   = binary_byte_order;
+        header.num_sections = static_cast<std::uint32_t>( _sections.size() );
+        header.reserved     = 0;
+
+        std::uint64_t offset = align( sizeof(binary_header_t) + _sections.size() * sizeof(binary_section_t) );
+        for (auto& s : _sections){
+            s.offset = offset;
+            offset   = align( offset + s.count * s.element_size );
+        }
+        header.size = offset;
+
+#if defined(COPS_HAS_MMAP)
+        const std::string temporary = path + ".tmp" + std::to_string( ::getpid() );
+#else
+        const std::string temporary = path + ".tmp";
+#endif
+        std::FILE* f = std::fopen(temporary.c_str(), "wb");
+        if ( !f ) throw std::runtime_error("BinaryWriter: cannot create " + temporary);
+
+        bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1;
+        if ( !_sections.empty() ) ok = ok && std::fwrite(_sections.data(), sizeof(binary_section_t), _sections.size(), f) == _sections.size();
+        std::uint64_t position = sizeof(binary_header_t) + _sections.size() * sizeof(binary_section_t);
+        for (std::size_t k = 0; ok && k < _sections.size(); ++k){
+            ok = pad(f, position, _sections[k].offset);
+            const std::size_t bytes = static_cast<std::size_t>( _sections[k].count * _sections[k].element_size );
+            ok = ok && ( bytes == 0 || std::fwrite(_data[k], 1, bytes, f) == bytes );
+            position += bytes;
+        }
+        ok = ok && pad(f, position, header.size);
+        ok = ( std::fclose(f) == 0 ) && ok;
+
+        if ( !ok || std::rename(temporary.c_str(), path.c_str()) != 0 ){
+            std::remove(temporary.c_str());
+            throw std::runtime_error("BinaryWriter: cannot write " + path);
+        }
+    }
+
+private:
+
+    static std::uint64_t align(std::uint64_t offset) noexcept {
+        return ( offset + binary_alignment - 1 ) / binary_alignment * binary_alignment;
+    }
+
+    static bool pad(std::FILE* f, std::uint64_t& position, std::uint64_t target){
+        static const char zeros[binary_alignment] = {};
+        const std::size_t n = static_cast<std::size_t>( target - position );
+        position = target;
+        return n == 0 || std::fwrite(zeros, 1, n, f) == n;
+    }
+
+    char                           _magic[8];
+    std::uint32_t                  _version;
+    std::vector<binary_section_t>  _sections;
+    std::vector<const void*>       _data;
+};
+
+// Maps a file written by BinaryWriter and gives typed, zero-copy access to its sections.
+// The constructor checks the magic, version, byte order and bounds, and throws std::runtime_error on mismatch.
+class BinaryFile{
+public:
+
+    BinaryFile(const std::string& path, const char* magic, std::uint32_t version):
+        _file(path){
+        if ( _file.size() < sizeof(binary_header_t) ) throw std::runtime_error("BinaryFile: " + path + " is too short");
+
+        const auto* header = reinterpret_cast<const binary_header_t*>( _file.data() );
+        char expected[8];
+        binary_magic(expected, magic);
+        if ( std::memcmp(header->magic, expected, sizeof(expected)) != 0 ) throw std::runtime_error("BinaryFile: " + path + " has a wrong magic number");
+        if ( header->byte_order != binary_byte_order ) throw std::runtime_error("BinaryFile: " + path + " has another byte order");
+        if ( header->version != version ) throw std::runtime_error("BinaryFile: " + path + " has another format version");
+        if ( header->size != _file.size() ) throw std::runtime_error("BinaryFile: " + path + " is truncated");
+
+        const std::uint64_t table_end = sizeof(binary_header_t) + std::uint64_t(header->num_sections) * sizeof(binary_section_t);
+        if ( table_end > _file.size() ) throw std::runtime_error("BinaryFile: " + path + " is truncated");
+        _sections = reinterpret_cast<const binary_section_t*>( _file.data() + sizeof(binary_header_t) );
+        _num_sections = header->num_sections;
+
+        for (std::size_t k = 0; k < _num_sections; ++k){
+            const auto& s = _sections[k];
+            if ( s.offset % binary_alignment != 0 || s.offset < table_end || s.offset > _file.size() ||
+                 s.count > ( _file.size() - s.offset ) / ( s.element_size ? s.element_size : 1 ) )
+                throw std::runtime_error("BinaryFile: " + path + " has a corrupt section table");
+        }
+    }
+
+    bool has(std::uint32_t id) const noexcept { return find(id) != nullptr; }
+
+    // number of elements of section id, 0 if there is no such section
+    std::size_t count(std::uint32_t id) const noexcept {
+        const binary_section_t* s = find(id);
+        return s ? static_cast<std::size_t>( s->count ) : 0;
+    }
+
+    // the elements of section id, in place; throws if the section is missing or holds another type
+    template< typename T >
+    const T* section(std::uint32_t id) const {
+        const binary_section_t* s = find(id);
+        if ( !s ) throw std::runtime_error("BinaryFile: missing section " + std::to_string(id));
+        if ( s->element_size != sizeof(T) ) throw std::runtime_error("BinaryFile: wrong element size in section " + std::to_string(id));
+        return reinterpret_cast<const T*>( _file.data() + s->offset );
+    }
+
+private:
+
+    const binary_section_t* find(std::uint32_t id) const noexcept {
+        for (std::size_t k = 0; k < _num_sections; ++k) if ( _sections[k].id == id ) return _sections + k;
+        return nullptr;
+    }
+
+    MappedFile              _file;
+    const binary_section_t* _sections = nullptr;
+    std::size_t             _num_sections = 0;
+};
+
+}
+}
+}
+
+#endif // COPS_BINARY_FILE_HPP
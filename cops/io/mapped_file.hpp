@@ -0,0 +1,111 @@
+#ifndef COPS_MAPPED_FILE_HPP
+#define COPS_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define COPS_HAS_MMAP 1
+#endif
+
+namespace onion{
+namespace cops {
+namespace io {
+
+// Read-only view of the contents of a file.
+//
+// On POSIX systems the file is memory-mapped: no copy is made, pages are read by the kernel as they are
+// touched (sequential read-ahead is requested) and the parsers read the text straight from the page cache.
+// Elsewhere the file is read into a buffer with a single fread.
+//
+// Throws std::runtime_error if the file cannot be opened or mapped.
+
+class MappedFile{
+public:
+
+    MappedFile() = default;
+
+    explicit MappedFile(const std::string& path){
+#if defined(COPS_HAS_MMAP)
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if ( fd < 0 ) throw std::runtime_error("MappedFile: cannot open " + path);
+
+        struct stat st;
+        if ( ::fstat(fd, &st) != 0 ){
+            ::close(fd);
+            throw std::runtime_error("MappedFile: cannot stat " + path);
+        }
+        _size = static_cast<std::size_t>( st.st_size );
+
+        if ( _size > 0 ){
+            void* p = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if ( p == MAP_FAILED ){
+                ::close(fd);
+                throw std::runtime_error("MappedFile: cannot map " + path);
+            }
+            ::madvise(p, _size, MADV_SEQUENTIAL);
+            _data = static_cast<const char*>(p);
+        }
+        ::close(fd);
+#else
+        std::FILE* f = std::fopen(path.c_str(), "rb");
+        if ( !f ) throw std::runtime_error("MappedFile: cannot open " + path);
+        std::fseek(f, 0, SEEK_END);
+        _buffer.resize( static_cast<std::size_t>( std::ftell(f) ) );
+        std::fseek(f, 0, SEEK_SET);
+        const std::size_t read = _buffer.empty() ? 0 : std::fread(_buffer.data(), 1, _buffer.size(), f);
+        std::fclose(f);
+        if ( read != _buffer.size() ) throw std::runtime_error("MappedFile: cannot read " + path);
+        _data = _buffer.data();
+        _size = _buffer.size();
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept { swap(other); }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        MappedFile tmp( std::move(other) );
+        swap(tmp);
+        return *this;
+    }
+
+    ~MappedFile(){
+#if defined(COPS_HAS_MMAP)
+        if ( _data ) ::munmap( const_cast<char*>(_data), _size );
+#endif
+    }
+
+    const char* data()  const noexcept { return _data; }
+    std::size_t size()  const noexcept { return _size; }
+    const char* begin() const noexcept { return _data; }
+    const char* end()   const noexcept { return _data + _size; }
+
+private:
+
+    void swap(MappedFile& other) noexcept {
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
+        _buffer.swap(other._buffer);
+    }
+
+    const char*       _data = nullptr;
+    std::size_t       _size = 0;
+    std::vector<char> _buffer;  // only without mmap
+};
+
+}
+}
+}
+
+#endif // COPS_MAPPED_FILE_HPP
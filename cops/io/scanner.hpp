@@ -0,0 +1,161 @@
+#ifndef COPS_SCANNER_HPP
+#define COPS_SCANNER_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace onion{
+namespace cops {
+namespace io {
+
+// Tokenizer for the numeric text formats of benchmark instances (TSPLIB, OR-Library ...).
+//
+// Reads a [begin,end) range of characters, typically a MappedFile, without copies, locales or iostreams.
+// Numbers are separated by white space (blanks, tabs and line breaks).
+//
+// - integer() accumulates the digits in a 64-bit integer; a value that does not fit is an error.
+// - real() takes the Clinger fast path when the digits fit in 53 bits and the decimal exponent in [-22,22]
+//   (one exact multiplication or division: correctly rounded, like strtod). Other numbers go to strtod.
+//
+// Throws std::runtime_error when a number is expected and something else is found; the message names the
+// source given to the constructor (the path of the file, typically).
+
+class Scanner{
+public:
+
+    Scanner(const char* begin, const char* end, const std::string& source = std::string()):
+        _p(begin),
+        _end(end),
+        _source(source){
+    }
+
+    bool eof() noexcept {
+        skip_space();
+        return _p == _end;
+    }
+
+    void skip_space() noexcept {
+        while ( _p != _end && is_space(*_p) ) ++_p;
+    }
+
+    // next sequence of characters up to a blank or line break
+    std::string token(){
+        skip_space();
+        const char* first = _p;
+        while ( _p != _end && !is_space(*_p) ) ++_p;
+        return std::string(first, _p);
+    }
+
+    // rest of the current line, without surrounding blanks; moves to the next line
+    std::string line(){
+        while ( _p != _end && ( *_p == ' ' || *_p == '\t' ) ) ++_p;
+        const char* first = _p;
+        while ( _p != _end && *_p != '\n' ) ++_p;
+        const char* last = _p;
+        while ( last != first && is_space( last[-1] ) ) --last;
+        if ( _p != _end ) ++_p;
+        return std::string(first, last);
+    }
+
+    std::int64_t integer(){
+        skip_space();
+        const char* first = _p;
+        bool negative = false;
+        if ( _p != _end && ( *_p == '-' || *_p == '+' ) ) negative = ( *_p++ == '-' );
+        if ( _p == _end || !is_digit(*_p) ) error("an integer");
+
+        const std::uint64_t limit = static_cast<std::uint64_t>( std::numeric_limits<std::int64_t>::max() );
+        std::uint64_t value = 0;
+        while ( _p != _end && is_digit(*_p) ){
+            const unsigned digit = static_cast<unsigned>( *_p - '0' );
+            if ( value > ( limit - digit ) / 10 ){
+                _p = first;
+                error("a 64-bit integer");
+            }
+            value = value * 10 + digit;
+            ++_p;
+        }
+        return negative ? -static_cast<std::int64_t>(value) : static_cast<std::int64_t>(value);
+    }
+
+    double real(){
+        skip_space();
+        const char* first = _p;
+        bool negative = false;
+        if ( _p != _end && ( *_p == '-' || *_p == '+' ) ) negative = ( *_p++ == '-' );
+
+        std::uint64_t mantissa = 0;
+        int digits = 0, exponent = 0;
+        bool any = false;
+        while ( _p != _end && is_digit(*_p) ){
+            mantissa = mantissa * 10 + static_cast<unsigned>( *_p++ - '0' );
+            ++digits;  any = true;
+        }
+        if ( _p != _end && *_p == '.' ){
+            ++_p;
+            while ( _p != _end && is_digit(*_p) ){
+                mantissa = mantissa * 10 + static_cast<unsigned>( *_p++ - '0' );
+                ++digits;  --exponent;  any = true;
+            }
+        }
+        if ( !any ) error("a number");
+        if ( _p != _end && ( *_p == 'e' || *_p == 'E' ) ){
+            ++_p;
+            bool negative_exponent = false;
+            if ( _p != _end && ( *_p == '-' || *_p == '+' ) ) negative_exponent = ( *_p++ == '-' );
+            if ( _p == _end || !is_digit(*_p) ) error("an exponent");
+            int e = 0;
+            while ( _p != _end && is_digit(*_p) ){
+                if ( e < 100000 ) e = e * 10 + ( *_p - '0' );
+                ++_p;
+            }
+            exponent += negative_exponent ? -e : e;
+        }
+
+        // fast path: 19 digits cannot overflow the mantissa, 2^53 and 10^22 are exact doubles
+        if ( digits <= 19 && mantissa <= ( std::uint64_t(1) << 53 ) && exponent >= -22 && exponent <= 22 ){
+            double value = static_cast<double>(mantissa);
+            if ( exponent < 0 ) value /= power10(-exponent);
+            else                value *= power10(exponent);
+            return negative ? -value : value;
+        }
+        return slow_real(first);
+    }
+
+private:
+
+    static bool is_space(char c) noexcept { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v'; }
+    static bool is_digit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+    static double power10(int e) noexcept {
+        static const double table[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9, 1e10, 1e11,
+                                        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+        return table[e];
+    }
+
+    // strtod needs a null terminated string: the token is copied
+    double slow_real(const char* first) const {
+        const std::string text(first, _p);
+        return std::strtod(text.c_str(), nullptr);
+    }
+
+    [[noreturn]] void error(const char* expected) const {
+        const char* last = _p;
+        while ( last != _end && !is_space(*last) && last - _p < 20 ) ++last;
+        throw std::runtime_error( std::string("Scanner: expected ") + expected + ", found '" + std::string(_p, last) + "'" +
+                                  ( _source.empty() ? std::string() : " in " + _source ) );
+    }
+
+    const char* _p;
+    const char* _end;
+    std::string _source;
+};
+
+}
+}
+}
+
+#endif // COPS_SCANNER_HPP
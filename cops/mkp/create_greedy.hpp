@@ -0,0 +1,66 @@
+#ifndef MKP_CREATE_GREEDY_HPP
+#define MKP_CREATE_GREEDY_HPP
+
+#include "mkp.hpp"
+#include "repair.hpp"
+#include "solution.hpp"
+#include "utility.hpp"
+#include "onion/CreateOperator.hpp"
+
+namespace onion{
+namespace cops {
+namespace mkp {
+
+// Surrogate greedy construction: starting from the empty knapsack, adds the items by decreasing
+// pseudo-utility (see utility.hpp) whenever they fit, the add phase of repair(). Deterministic.
+// The order is computed once, at construction, or shared with a Repair operator.
+
+class CreateGreedy : public onion::CreateOperator< Solution >
+{
+public:
+
+    CreateGreedy(const instance_t& instance):
+        ComponentID( IDBuilder()
+                    .name("CreateGreedy")
+                    .description("Adds items by decreasing surrogate pseudo-utility while they fit.")
+                    .type("Create Operator")
+                    .version("v0.1.0")
+                    .problem("MKP")),
+        _instance(instance),
+        _own_order(instance),
+        _order(_own_order){
+    }
+
+    CreateGreedy(const instance_t& instance, const UtilityOrder& order):
+        ComponentID( IDBuilder()
+                    .name("CreateGreedy")
+                    .description("Adds items by decreasing surrogate pseudo-utility while they fit.")
+                    .type("Create Operator")
+                    .version("v0.1.0")
+                    .problem("MKP")),
+        _instance(instance),
+        _order(order){
+    }
+
+    // _order may refer to _own_order: a copy would refer to the order of the original
+    CreateGreedy(const CreateGreedy&) = delete;
+    CreateGreedy& operator=(const CreateGreedy&) = delete;
+
+    virtual Solution operator()(void){
+        Solution s(_instance);
+        repair(s, _order);
+        return s;
+    }
+
+private:
+
+    const instance_t&   _instance;
+    UtilityOrder        _own_order;
+    const UtilityOrder& _order;
+};
+
+}
+}
+}
+
+#endif // MKP_CREATE_GREEDY_HPP
@@ -0,0 +1,56 @@
+#ifndef MKP_CREATE_RANDOM_HPP
+#define MKP_CREATE_RANDOM_HPP
+
+#include "mkp.hpp"
+#include "solution.hpp"
+#include "onion/CreateOperator.hpp"
+#include "onion/Random.hpp"
+#include <utility>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace mkp {
+
+// Random feasible solution: the items are visited in a uniform random order (Fisher-Yates, drawn from
+// onion::Random()) and each one is added if it fits. The result is maximal: no item can be added without
+// violating a constraint. O(n m / 8).
+
+class CreateRandom : public onion::CreateOperator< Solution >
+{
+public:
+
+    CreateRandom(const instance_t& instance):
+        ComponentID( IDBuilder()
+                    .name("CreateRandom")
+                    .description("Creates a random maximal feasible selection of items.")
+                    .type("Create Operator")
+                    .version("v0.1.0")
+                    .problem("MKP")),
+        _instance(instance),
+        _order(instance.num_items){
+        for (unsigned int j = 0; j < instance.num_items; ++j) _order[j] = j;
+    }
+
+    virtual Solution operator()(void){
+        auto& rng = onion::Random();
+        for (unsigned int k = _instance.num_items; k > 1; --k){
+            const unsigned int r = rng.uniform_int_between(0, k - 1);
+            std::swap( _order[k - 1], _order[r] );
+        }
+        Solution s(_instance);
+        for (unsigned int j : _order) if ( s.fits(j) ) s.add(j);
+        return s;
+    }
+
+private:
+
+    const instance_t&         _instance;
+    std::vector<unsigned int> _order;
+};
+
+}
+}
+}
+
+#endif // MKP_CREATE_RANDOM_HPP
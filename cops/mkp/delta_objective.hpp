@@ -0,0 +1,103 @@
+#ifndef MKP_DELTA_OBJECTIVE_HPP
+#define MKP_DELTA_OBJECTIVE_HPP
+
+#include "moves.hpp"
+#include "objective.hpp"
+#include "solution.hpp"
+#include "onion/DeltaObjective.hpp"
+#include <cstdint>
+
+namespace onion{
+namespace cops {
+namespace mkp {
+
+// Delta objective functions of Profit (see objective.hpp) for the moves in moves.hpp: the variation of
+// profit - penalty * violation. The profit part is O(1); with a non-zero penalty the variation of the
+// violation reads the slacks and the columns of the moved items, O(m), without changing the solution.
+
+namespace detail{
+
+// excess weight when slack[i] + plus[i] - minus[i] is the slack of constraint i (plus or minus may be null)
+inline std::int64_t violation(const Solution& s, const value_t* plus, const value_t* minus) noexcept {
+    const value_t* slack = s.slack();
+    std::int64_t   excess = 0;
+    for (unsigned int i = 0; i < s.instance().num_constraints; ++i){
+        const std::int64_t v = std::int64_t( slack[i] ) + ( plus ? plus[i] : 0 ) - ( minus ? minus[i] : 0 );
+        if ( v < 0 ) excess -= v;
+    }
+    return excess;
+}
+
+}
+
+class DeltaFlip : public onion::DeltaObjective< Solution, flip_t, std::int64_t >
+{
+public:
+
+    DeltaFlip(std::int64_t penalty = 0):
+        ComponentID( IDBuilder()
+                    .name("DeltaFlip")
+                    .description("Variation of the penalized profit caused by flipping an item.")
+                    .type("Delta Objective")
+                    .version("v0.1.0")
+                    .problem("MKP")),
+        _penalty(penalty){
+    }
+
+    virtual std::int64_t operator()(const Solution& s, const flip_t& m){
+        return delta(s, m, _penalty);
+    }
+
+    static inline std::int64_t delta(const Solution& s, const flip_t& m, std::int64_t penalty){
+        const instance_t& instance = s.instance();
+        const bool        in = s.contains(m.j);
+        std::int64_t      d  = in ? -std::int64_t( instance.profits[m.j] ) : std::int64_t( instance.profits[m.j] );
+        if ( penalty ){
+            const value_t* w = instance.column(m.j);
+            d -= penalty * ( detail::violation(s, in ? w : nullptr, in ? nullptr : w) - s.violation() );
+        }
+        return d;
+    }
+
+private:
+
+    std::int64_t _penalty;
+};
+
+class DeltaSwap : public onion::DeltaObjective< Solution, swap_t, std::int64_t >
+{
+public:
+
+    DeltaSwap(std::int64_t penalty = 0):
+        ComponentID( IDBuilder()
+                    .name("DeltaSwap")
+                    .description("Variation of the penalized profit caused by replacing a selected item.")
+                    .type("Delta Objective")
+                    .version("v0.1.0")
+                    .problem("MKP")),
+        _penalty(penalty){
+    }
+
+    virtual std::int64_t operator()(const Solution& s, const swap_t& m){
+        return delta(s, m, _penalty);
+    }
+
+    static inline std::int64_t delta(const Solution& s, const swap_t& m, std::int64_t penalty){
+        const instance_t& instance = s.instance();
+        std::int64_t      d = std::int64_t( instance.profits[m.in] ) - instance.profits[m.out];
+        if ( penalty ){
+            d -= penalty * ( detail::violation(s, instance.column(m.out), instance.column(m.in)) - s.violation() );
+        }
+        return d;
+    }
+
+private:
+
+    std::int64_t _penalty;
+};
+
+}
+}
+}
+
+#endif // MKP_DELTA_OBJECTIVE_HPP
@@ -1 +1,59 @@
-//placeholder
+#ifndef MKP_HPP
+#define MKP_HPP
+
+#include "onion/AlignedAllocator.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace mkp {
+
+// Multidimensional (multi-constraint) 0-1 knapsack problem:
+//
+//     maximize    sum_j profit[j] x[j]
+//     subject to  sum_j weight[i][j] x[j] <= capacity[i],  i = 0 .. num_constraints - 1
+//                 x[j] in {0,1},                           j = 0 .. num_items - 1
+//
+// Weights are stored row by row (one row per constraint) in a single aligned array, so the weights of
+// a constraint are contiguous: weight(i,j) = weights[ i * num_items + j ].
+//
+// Solutions (see solution.hpp) add or remove an item by updating all the constraints at once: they read the
+// weights of an item, column(j), from a second copy stored item by item. Each column is padded with zeros
+// to stride() values, a multiple of 8 (one AVX2 register of value_t), and starts on a 32-byte boundary.
+// make_columns() builds it from weights, and must be called again if weights change (read_orlib calls it).
+//
+// The sums of weights of a constraint must fit in value_t.
+
+using value_t = std::int32_t;
+using values_t = std::vector< value_t, onion::AlignedAllocator<value_t> >;
+
+struct instance_t{
+    unsigned int num_items       = 0;
+    unsigned int num_constraints = 0;
+    values_t     profits;       // num_items
+    values_t     weights;       // num_constraints x num_items
+    values_t     capacities;    // num_constraints
+    values_t     columns;       // num_items x stride(), see make_columns()
+    std::int64_t optimum = 0;   // best known value, 0 if unknown
+
+    value_t        weight(unsigned int i, unsigned int j) const noexcept { return weights[ std::size_t(i) * num_items + j ]; }
+    const value_t* row(unsigned int i)                    const noexcept { return weights.data() + std::size_t(i) * num_items; }
+
+    unsigned int   stride()                const noexcept { return ( num_constraints + 7 ) / 8 * 8; }
+    const value_t* column(unsigned int j)  const noexcept { return columns.data() + std::size_t(j) * stride(); }
+
+    void make_columns(){
+        columns.assign( std::size_t(num_items) * stride(), 0 );
+        for (unsigned int i = 0; i < num_constraints; ++i){
+            for (unsigned int j = 0; j < num_items; ++j) columns[ std::size_t(j) * stride() + i ] = weight(i, j);
+        }
+    }
+};
+
+}
+}
+}
+
+#endif // MKP_HPP
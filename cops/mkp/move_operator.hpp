@@ -0,0 +1,75 @@
+#ifndef MKP_MOVE_OPERATOR_HPP
+#define MKP_MOVE_OPERATOR_HPP
+
+#include "moves.hpp"
+#include "solution.hpp"
+#include "onion/MoveOperator.hpp"
+
+namespace onion{
+namespace cops {
+namespace mkp {
+
+// In-place implementations of the moves in moves.hpp: each item changed updates the slacks with one
+// SIMD pass over its column, O(m / 8). apply() returns the parameter of the inverse move as undo token.
+
+class FlipMove : public onion::MoveOperator< Solution, flip_t >
+{
+public:
+
+    FlipMove():
+        ComponentID( IDBuilder()
+                    .name("FlipMove")
+                    .description("Adds or removes an item in place.")
+                    .type("Move Operator")
+                    .version("v0.1.0")
+                    .problem("MKP")){
+    }
+
+    virtual flip_t apply(Solution& s, const flip_t& m){
+        return move(s, m);
+    }
+
+    virtual void undo(Solution& s, const flip_t& u){
+        move(s, u);
+    }
+
+    // a flip is its own inverse
+    static inline flip_t move(Solution& s, const flip_t& m){
+        s.flip(m.j);
+        return m;
+    }
+};
+
+class SwapMove : public onion::MoveOperator< Solution, swap_t >
+{
+public:
+
+    SwapMove():
+        ComponentID( IDBuilder()
+                    .name("SwapMove")
+                    .description("Replaces a selected item by another one in place.")
+                    .type("Move Operator")
+                    .version("v0.1.0")
+                    .problem("MKP")){
+    }
+
+    virtual swap_t apply(Solution& s, const swap_t& m){
+        return move(s, m);
+    }
+
+    virtual void undo(Solution& s, const swap_t& u){
+        move(s, u);
+    }
+
+    static inline swap_t move(Solution& s, const swap_t& m){
+        s.remove(m.out);
+        s.add(m.in);
+        return swap_t{ m.in, m.out };
+    }
+};
+
+}
+}
+}
+
+#endif // MKP_MOVE_OPERATOR_HPP
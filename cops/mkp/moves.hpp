@@ -0,0 +1,25 @@
+#ifndef MKP_MOVES_HPP
+#define MKP_MOVES_HPP
+
+namespace onion{
+namespace cops {
+namespace mkp {
+
+// Transformation parameters for solutions (see solution.hpp).
+
+// Flip: adds item j if it is not selected, removes it otherwise.
+struct flip_t{
+    unsigned int j;
+};
+
+// Swap: removes the selected item out and adds the item in, which is not selected.
+struct swap_t{
+    unsigned int out;
+    unsigned int in;
+};
+
+}
+}
+}
+
+#endif // MKP_MOVES_HPP
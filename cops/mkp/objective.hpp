@@ -0,0 +1,52 @@
+#ifndef MKP_OBJECTIVE_HPP
+#define MKP_OBJECTIVE_HPP
+
+#include "solution.hpp"
+#include "onion/ObjectiveFunction.hpp"
+#include <cstdint>
+
+namespace onion{
+namespace cops {
+namespace mkp {
+
+// Total profit of the selected items, to maximize, minus penalty times the excess weight over the capacities
+// (Solution::violation()). With the default penalty of 0 the value of an infeasible solution is its profit:
+// searches that may leave the feasible region should set a penalty larger than the best profit per unit of
+// weight, so that no infeasible solution beats the feasible ones around it.
+//
+// O(1) for feasible solutions or a zero penalty (the profit is kept by the solution), O(m) otherwise.
+
+class Profit : public onion::ObjectiveFunction< Solution, std::int64_t >
+{
+public:
+
+    Profit(std::int64_t penalty = 0):
+        ComponentID( IDBuilder()
+                    .name("Profit")
+                    .description("Profit of the selected items, minus a penalty on the excess weight.")
+                    .type("Objective Function")
+                    .version("v0.1.0")
+                    .problem("MKP")),
+        _penalty(penalty){
+    }
+
+    virtual std::int64_t operator()(const Solution& s){
+        return value(s, _penalty);
+    }
+
+    std::int64_t penalty() const noexcept { return _penalty; }
+
+    static inline std::int64_t value(const Solution& s, std::int64_t penalty){
+        return penalty ? s.profit() - penalty * s.violation() : s.profit();
+    }
+
+private:
+
+    std::int64_t _penalty;
+};
+
+}
+}
+}
+
+#endif // MKP_OBJECTIVE_HPP
@@ -0,0 +1,73 @@
+#ifndef MKP_ORLIB_HPP
+#define MKP_ORLIB_HPP
+
+#include "mkp.hpp"
+#include "../io/mapped_file.hpp"
+#include "../io/scanner.hpp"
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace mkp {
+
+namespace detail{
+
+inline value_t orlib_value(io::Scanner& in, const char* field, const std::string& path){
+    const std::int64_t v = in.integer();
+    if ( v < std::numeric_limits<value_t>::min() || v > std::numeric_limits<value_t>::max() )
+        throw std::runtime_error(std::string("OR-Library: ") + field + " out of range in " + path);
+    return static_cast<value_t>(v);
+}
+
+}
+
+// Reads the MKP instances of an OR-Library file in the format of mknap1.txt and mknapcb1.txt .. mknapcb9.txt:
+//
+//     number of instances K
+//     then, for each instance:
+//         n m optimum          (optimum is 0 when unknown)
+//         n profits
+//         m rows of n weights
+//         m capacities
+//
+// Values may be spread over any number of lines. The file is memory-mapped and parsed with io::Scanner.
+// Throws std::runtime_error if the file cannot be read or is malformed.
+inline std::vector<instance_t> read_orlib(const std::string& path){
+    const io::MappedFile file(path);
+    io::Scanner in( file.begin(), file.end(), path );
+
+    // a file of size characters holds fewer than size numbers: larger counts are corrupt, and are rejected
+    // before the vectors are allocated
+    const std::int64_t size  = file.end() - file.begin();
+    const std::int64_t count = in.integer();
+    if ( count < 0 || count > size ) throw std::runtime_error("OR-Library: invalid number of instances in " + path);
+
+    std::vector<instance_t> instances( static_cast<std::size_t>(count) );
+    for (auto& instance : instances){
+        const std::int64_t n = in.integer(), m = in.integer();
+        if ( n <= 0 || m <= 0 || n > size / m ) throw std::runtime_error("OR-Library: invalid instance size in " + path);
+        instance.num_items       = static_cast<unsigned int>(n);
+        instance.num_constraints = static_cast<unsigned int>(m);
+        instance.optimum         = static_cast<std::int64_t>( in.real() );
+
+        instance.profits.resize( instance.num_items );
+        instance.weights.resize( std::size_t(instance.num_items) * instance.num_constraints );
+        instance.capacities.resize( instance.num_constraints );
+
+        for (auto& v : instance.profits)    v = detail::orlib_value(in, "profit", path);
+        for (auto& v : instance.weights)    v = detail::orlib_value(in, "weight", path);
+        for (auto& v : instance.capacities) v = detail::orlib_value(in, "capacity", path);
+        instance.make_columns();
+    }
+    return instances;
+}
+
+}
+}
+}
+
+#endif // MKP_ORLIB_HPP
@@ -0,0 +1,56 @@
+#ifndef MKP_PARAMETER_OPERATOR_HPP
+#define MKP_PARAMETER_OPERATOR_HPP
+
+#include "moves.hpp"
+#include "solution.hpp"
+#include "onion/ParameterOperator.hpp"
+#include "onion/Random.hpp"
+
+namespace onion{
+namespace cops {
+namespace mkp {
+
+// Random flip of an item drawn uniformly among the num_items items. A flip is valid for every solution, so
+// the parameter does not depend on the solution (swaps do: see SwapItems::draw in perturbation.hpp).
+//
+// engine_t : the engine given to the constructor, if any. The items are drawn from it, or from
+//            onion::Random() without one. Random() is a virtual call per draw: with a final engine_t
+//            (RandomXoshiro256) and an engine, the draws are direct calls the compiler can inline.
+//            The engine must then be used by a single thread.
+
+template< typename engine_t = onion::RandomEngine >
+class RandomFlip : public onion::ParameterOperator< Solution, flip_t >
+{
+public:
+
+    explicit RandomFlip(unsigned int num_items, engine_t* engine = nullptr):
+        ComponentID( IDBuilder()
+                    .name("RandomFlip")
+                    .description("Draws a random item to add or remove.")
+                    .type("Parameter Operator")
+                    .version("v0.1.0")
+                    .problem("MKP")),
+        _num_items(num_items),
+        _engine(engine){
+    }
+
+    virtual flip_t operator()(){
+        return _engine ? draw(*_engine) : draw( onion::Random() );
+    }
+
+    template< typename rng_t >
+    flip_t draw(rng_t& rng) const noexcept {
+        return flip_t{ rng.uniform_int_between(0, _num_items - 1) };
+    }
+
+private:
+
+    unsigned int _num_items;
+    engine_t*    _engine;
+};
+
+}
+}
+}
+
+#endif // MKP_PARAMETER_OPERATOR_HPP
@@ -0,0 +1,103 @@
+#ifndef MKP_PERTURBATION_HPP
+#define MKP_PERTURBATION_HPP
+
+#include "moves.hpp"
+#include "move_operator.hpp"
+#include "solution.hpp"
+#include "../bits.hpp"
+#include "onion/PerturbationOperator.hpp"
+#include "onion/Random.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace onion{
+namespace cops {
+namespace mkp {
+
+// Random neighbours of a solution, returned as copies; the moves are drawn from onion::Random().
+// Neither operator restores feasibility: pair them with a penalized Profit (see objective.hpp) or reject
+// the neighbours that are not feasible().
+//
+// FlipItem  : flips an item drawn uniformly among all items
+// SwapItems : replaces a selected item by an unselected one, both drawn uniformly. The solution is
+//             returned unchanged if every item, or none, is selected
+
+namespace detail{
+
+// the k-th item (from 0) that is selected, or not selected, in s
+inline unsigned int nth_item(const Solution& s, std::size_t k, bool selected) noexcept {
+    const std::uint64_t* bits = s.bits();
+    for (std::size_t w = 0; ; ++w){
+        std::uint64_t word = selected ? bits[w] : ~bits[w];
+        if ( !selected && w + 1 == s.words() && s.size() % 64 ) word &= ( std::uint64_t(1) << ( s.size() % 64 ) ) - 1;
+        const unsigned int count = popcount(word);
+        if ( k < count ){
+            for (; k > 0; --k) word &= word - 1;
+            return static_cast<unsigned int>( w * 64 + lowest_bit(word) );
+        }
+        k -= count;
+    }
+}
+
+}
+
+class FlipItem : public onion::PerturbationOperator< Solution, Solution >
+{
+public:
+
+    FlipItem():
+        ComponentID( IDBuilder()
+                    .name("FlipItem")
+                    .description("Adds or removes a random item.")
+                    .type("Perturbation Operator")
+                    .version("v0.1.0")
+                    .problem("MKP")){
+    }
+
+    virtual Solution operator()(const Solution& s){
+        Solution r(s);
+        FlipMove::move( r, draw(s) );
+        return r;
+    }
+
+    static inline flip_t draw(const Solution& s){
+        return flip_t{ static_cast<unsigned int>( onion::Random().uniform_int_between(0, s.size() - 1) ) };
+    }
+};
+
+class SwapItems : public onion::PerturbationOperator< Solution, Solution >
+{
+public:
+
+    SwapItems():
+        ComponentID( IDBuilder()
+                    .name("SwapItems")
+                    .description("Replaces a random selected item by a random unselected one.")
+                    .type("Perturbation Operator")
+                    .version("v0.1.0")
+                    .problem("MKP")){
+    }
+
+    virtual Solution operator()(const Solution& s){
+        Solution r(s);
+        swap_t m;
+        if ( draw(s, m) ) SwapMove::move(r, m);
+        return r;
+    }
+
+    // false if no swap exists
+    static inline bool draw(const Solution& s, swap_t& m){
+        const std::size_t selected = s.num_selected();
+        if ( selected == 0 || selected == s.size() ) return false;
+        auto& rng = onion::Random();
+        m.out = detail::nth_item( s, rng.uniform_int_between(0, static_cast<unsigned int>( selected - 1 )), true );
+        m.in  = detail::nth_item( s, rng.uniform_int_between(0, static_cast<unsigned int>( s.size() - selected - 1 )), false );
+        return true;
+    }
+};
+
+}
+}
+}
+
+#endif // MKP_PERTURBATION_HPP
@@ -0,0 +1,93 @@
+#ifndef MKP_REPAIR_HPP
+#define MKP_REPAIR_HPP
+
+#include "solution.hpp"
+#include "utility.hpp"
+#include "onion/PerturbationOperator.hpp"
+#include <cstddef>
+
+namespace onion{
+namespace cops {
+namespace mkp {
+
+// Drop/add repair of Chu and Beasley: makes a solution feasible and maximal, in place.
+//
+// - drop : while the solution is infeasible, removes the selected item of lowest utility
+// - add  : visits the items by decreasing utility and adds each one that fits
+//
+// Both phases walk the cached UtilityOrder (see utility.hpp): nothing is sorted per call. An item that is
+// skipped costs one bit test, and the drop phase only tests feasibility again after a removal. In the add
+// phase, once the knapsack is nearly full most items are rejected by the same constraint: that constraint
+// is tested first, O(1), and the SIMD test of all the slacks (Solution::fits) only runs for the items that
+// pass it. Each item that is removed or added updates the slacks in O(m / 8). A feasible solution goes
+// straight to the add phase.
+
+inline void repair(Solution& s, const UtilityOrder& order){
+    const std::vector<unsigned int>& items = order.order();
+    const instance_t& instance = s.instance();
+
+    if ( !s.feasible() ){
+        for (std::size_t k = items.size(); k-- > 0; ){
+            if ( !s.contains( items[k] ) ) continue;
+            s.remove( items[k] );
+            if ( s.feasible() ) break;
+        }
+    }
+
+    // without constraints every item fits, and there is no blocking constraint to test first
+    if ( instance.num_constraints == 0 ){
+        for (unsigned int j : items) if ( !s.contains(j) ) s.add(j);
+        return;
+    }
+
+    const value_t* slack = s.slack();
+    unsigned int   blocking = 0;
+    for (unsigned int j : items){
+        if ( s.contains(j) ) continue;
+        const value_t* w = instance.column(j);
+        if ( w[blocking] > slack[blocking] ) continue;
+        if ( s.fits(j) ){
+            s.add(j);
+            continue;
+        }
+        for (unsigned int i = 0; i < instance.num_constraints; ++i){
+            if ( w[i] > slack[i] ){
+                blocking = i;
+                break;
+            }
+        }
+    }
+}
+
+// Copy-returning form of repair(), for the frameworks that chain perturbation operators.
+
+class Repair : public onion::PerturbationOperator< Solution, Solution >
+{
+public:
+
+    Repair(const UtilityOrder& order):
+        ComponentID( IDBuilder()
+                    .name("Repair")
+                    .description("Drops the items of lowest pseudo-utility until feasible, then adds items greedily.")
+                    .type("Perturbation Operator")
+                    .version("v0.1.0")
+                    .problem("MKP")),
+        _order(order){
+    }
+
+    virtual Solution operator()(const Solution& s){
+        Solution r(s);
+        repair(r, _order);
+        return r;
+    }
+
+private:
+
+    const UtilityOrder& _order;
+};
+
+}
+}
+}
+
+#endif // MKP_REPAIR_HPP
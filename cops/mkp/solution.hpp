@@ -0,0 +1,189 @@
+#ifndef MKP_SOLUTION_HPP
+#define MKP_SOLUTION_HPP
+
+#include "mkp.hpp"
+#include "../bits.hpp"
+#include "onion/AlignedAllocator.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace onion{
+namespace cops {
+namespace mkp {
+
+// Solution of an MKP instance: the selected items as a bitset (bit j of word j / 64), the total profit and
+// the slack of every constraint, capacity[i] - sum of the weights of the selected items in constraint i.
+//
+// The slacks are one contiguous array of instance.stride() values (structure of arrays: one value per
+// constraint, not one record per item or per constraint), laid out like the columns of the instance. So:
+//
+// - add(j), remove(j), flip(j) : update every slack with the column of item j, 8 constraints per AVX2
+//                                subtraction (or addition), O(m / 8)
+// - feasible()                 : no slack is negative. The slacks are ORed together and the sign bits of
+//                                the result tested, with no branch per constraint
+// - fits(j)                    : adding item j keeps the solution feasible, the same sign test on
+//                                slack - column(j), without writing it
+//
+// The padding lanes of the slacks stay at 0: they never change the sign tests.
+// A solution keeps a pointer to its instance, which must outlive it; copies share the instance.
+
+namespace detail{
+
+inline void add_column(value_t* slack, const value_t* column, unsigned int stride) noexcept {
+    unsigned int i = 0;
+#if defined(__AVX2__)
+    for (; i < stride; i += 8){
+        __m256i* s = reinterpret_cast<__m256i*>( slack + i );
+        _mm256_store_si256( s, _mm256_add_epi32( _mm256_load_si256(s),
+                                                 _mm256_load_si256( reinterpret_cast<const __m256i*>( column + i ) ) ) );
+    }
+#endif
+    for (; i < stride; ++i) slack[i] += column[i];
+}
+
+inline void subtract_column(value_t* slack, const value_t* column, unsigned int stride) noexcept {
+    unsigned int i = 0;
+#if defined(__AVX2__)
+    for (; i < stride; i += 8){
+        __m256i* s = reinterpret_cast<__m256i*>( slack + i );
+        _mm256_store_si256( s, _mm256_sub_epi32( _mm256_load_si256(s),
+                                                 _mm256_load_si256( reinterpret_cast<const __m256i*>( column + i ) ) ) );
+    }
+#endif
+    for (; i < stride; ++i) slack[i] -= column[i];
+}
+
+// some slack[i] < 0
+inline bool any_negative(const value_t* slack, unsigned int stride) noexcept {
+    unsigned int i = 0;
+#if defined(__AVX2__)
+    __m256i any = _mm256_setzero_si256();
+    for (; i < stride; i += 8) any = _mm256_or_si256( any, _mm256_load_si256( reinterpret_cast<const __m256i*>( slack + i ) ) );
+    if ( _mm256_movemask_ps( _mm256_castsi256_ps(any) ) ) return true;
+#endif
+    value_t bits = 0;
+    for (; i < stride; ++i) bits |= slack[i];
+    return bits < 0;
+}
+
+// some slack[i] - column[i] < 0
+inline bool any_negative(const value_t* slack, const value_t* column, unsigned int stride) noexcept {
+    unsigned int i = 0;
+#if defined(__AVX2__)
+    __m256i any = _mm256_setzero_si256();
+    for (; i < stride; i += 8){
+        any = _mm256_or_si256( any, _mm256_sub_epi32( _mm256_load_si256( reinterpret_cast<const __m256i*>( slack + i ) ),
+                                                      _mm256_load_si256( reinterpret_cast<const __m256i*>( column + i ) ) ) );
+    }
+    if ( _mm256_movemask_ps( _mm256_castsi256_ps(any) ) ) return true;
+#endif
+    value_t bits = 0;
+    for (; i < stride; ++i) bits |= slack[i] - column[i];
+    return bits < 0;
+}
+
+}
+
+class Solution{
+public:
+
+    Solution() = default;
+
+    // the empty knapsack
+    explicit Solution(const instance_t& instance):
+        _instance(&instance),
+        _bits( ( std::size_t(instance.num_items) + 63 ) / 64, 0 ),
+        _slack( instance.stride(), 0 ){
+        for (unsigned int i = 0; i < instance.num_constraints; ++i) _slack[i] = instance.capacities[i];
+    }
+
+    const instance_t& instance() const noexcept { return *_instance; }
+
+    unsigned int size() const noexcept { return _instance->num_items; }
+
+    bool contains(unsigned int j) const noexcept {
+        return ( _bits[ j / 64 ] >> ( j % 64 ) ) & 1;
+    }
+
+    // j must not be selected
+    void add(unsigned int j) noexcept {
+        _bits[ j / 64 ] |= std::uint64_t(1) << ( j % 64 );
+        _profit += _instance->profits[j];
+        detail::subtract_column( _slack.data(), _instance->column(j), _instance->stride() );
+    }
+
+    // j must be selected
+    void remove(unsigned int j) noexcept {
+        _bits[ j / 64 ] &= ~( std::uint64_t(1) << ( j % 64 ) );
+        _profit -= _instance->profits[j];
+        detail::add_column( _slack.data(), _instance->column(j), _instance->stride() );
+    }
+
+    void flip(unsigned int j) noexcept {
+        if ( contains(j) ) remove(j);
+        else               add(j);
+    }
+
+    void clear() noexcept {
+        for (auto& w : _bits) w = 0;
+        _profit = 0;
+        for (unsigned int i = 0; i < _instance->num_constraints; ++i) _slack[i] = _instance->capacities[i];
+    }
+
+    bool feasible() const noexcept {
+        return !detail::any_negative( _slack.data(), _instance->stride() );
+    }
+
+    // adding item j (not selected) leaves every constraint satisfied
+    bool fits(unsigned int j) const noexcept {
+        return !detail::any_negative( _slack.data(), _instance->column(j), _instance->stride() );
+    }
+
+    std::int64_t profit() const noexcept { return _profit; }
+
+    // total excess weight over the capacities, 0 if feasible
+    std::int64_t violation() const noexcept {
+        std::int64_t excess = 0;
+        for (unsigned int i = 0; i < _instance->num_constraints; ++i) if ( _slack[i] < 0 ) excess -= _slack[i];
+        return excess;
+    }
+
+    std::size_t num_selected() const noexcept { return popcount( _bits.data(), _bits.size() ); }
+
+    // slack[i] = capacity[i] - weight of the selected items in constraint i, for i < num_constraints
+    const value_t*       slack() const noexcept { return _slack.data(); }
+    const std::uint64_t* bits()  const noexcept { return _bits.data(); }
+    std::size_t          words() const noexcept { return _bits.size(); }
+
+    // calls f(j) for each selected item j, in increasing order
+    template< typename function_t >
+    void for_each_item(function_t f) const {
+        for (std::size_t w = 0; w < _bits.size(); ++w){
+            for (std::uint64_t bits = _bits[w]; bits; bits &= bits - 1){
+                f( static_cast<unsigned int>( w * 64 + lowest_bit(bits) ) );
+            }
+        }
+    }
+
+    // same selected items (profit and slacks follow)
+    bool operator==(const Solution& other) const noexcept { return _bits == other._bits; }
+    bool operator!=(const Solution& other) const noexcept { return !( *this == other ); }
+
+private:
+
+    const instance_t* _instance = nullptr;
+    std::vector< std::uint64_t, onion::AlignedAllocator<std::uint64_t> > _bits;
+    values_t          _slack;
+    std::int64_t      _profit = 0;
+};
+
+}
+}
+}
+
+#endif // MKP_SOLUTION_HPP
@@ -0,0 +1,77 @@
+#ifndef MKP_UTILITY_HPP
+#define MKP_UTILITY_HPP
+
+#include "mkp.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace mkp {
+
+// Pseudo-utility order of the items (Chu and Beasley, "A genetic algorithm for the multidimensional knapsack
+// problem"): the m constraints are merged into one surrogate constraint with multipliers mu[i], and item j
+// is ranked by its profit per unit of surrogate weight,
+//
+//     utility[j] = profit[j] / sum_i mu[i] weight[i][j]
+//
+// Chu and Beasley take the dual values of the LP relaxation as multipliers: pass them to the second
+// constructor when an LP solver is at hand. The first constructor uses mu[i] = 1 / capacity[i], which
+// weights each constraint by the fraction of its capacity an item takes. Items with no surrogate weight
+// come first.
+//
+// The order is computed and sorted once, O(n m + n log n), and then shared by every repair and greedy
+// construction (see repair.hpp) with no further sorting.
+
+class UtilityOrder{
+public:
+
+    UtilityOrder() = default;
+
+    explicit UtilityOrder(const instance_t& instance):
+        UtilityOrder( instance, capacity_multipliers(instance) ){
+    }
+
+    // multipliers: num_constraints values, not negative
+    UtilityOrder(const instance_t& instance, const std::vector<double>& multipliers):
+        _utility(instance.num_items),
+        _order(instance.num_items){
+        for (unsigned int j = 0; j < instance.num_items; ++j){
+            const value_t* w = instance.column(j);
+            double surrogate = 0;
+            for (unsigned int i = 0; i < instance.num_constraints; ++i) surrogate += multipliers[i] * w[i];
+            _utility[j] = surrogate > 0 ? instance.profits[j] / surrogate : std::numeric_limits<double>::infinity();
+            _order[j]   = j;
+        }
+        std::stable_sort( _order.begin(), _order.end(),
+                          [this](unsigned int a, unsigned int b){ return _utility[a] > _utility[b]; } );
+    }
+
+    unsigned int size() const noexcept { return static_cast<unsigned int>( _order.size() ); }
+
+    double utility(unsigned int j) const noexcept { return _utility[j]; }
+
+    // items by decreasing utility
+    const std::vector<unsigned int>& order() const noexcept { return _order; }
+
+    static std::vector<double> capacity_multipliers(const instance_t& instance){
+        std::vector<double> mu(instance.num_constraints);
+        for (unsigned int i = 0; i < instance.num_constraints; ++i){
+            mu[i] = instance.capacities[i] > 0 ? 1.0 / instance.capacities[i] : 1.0;
+        }
+        return mu;
+    }
+
+private:
+
+    std::vector<double>       _utility;
+    std::vector<unsigned int> _order;
+};
+
+}
+}
+}
+
+#endif // MKP_UTILITY_HPP
@@ -0,0 +1,36 @@
+#ifndef COPS_PARALLEL_HPP
+#define COPS_PARALLEL_HPP
+
+#include "onion/ThreadPool.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+
+namespace onion{
+namespace cops {
+
+// Number of threads to use for a request of num_threads: 0 means one per hardware thread.
+inline unsigned int thread_count(unsigned int num_threads) noexcept {
+    if ( num_threads ) return num_threads;
+    const unsigned int hardware = std::thread::hardware_concurrency();
+    return hardware ? hardware : 1;
+}
+
+// ThreadPool::parallel_for() on a pool of num_threads threads (the calling thread is one of them) that
+// lives for the duration of the loop: for the one-off loops that build an instance, where keeping a pool
+// around is not worth it.
+template< typename function_t >
+void parallel_for(std::size_t n, unsigned int num_threads, function_t f){
+    num_threads = thread_count(num_threads);
+    if ( num_threads == 1 || n < 2 ){
+        if ( n ) f(std::size_t(0), n);
+        return;
+    }
+    ThreadPool pool( static_cast<unsigned int>( std::min<std::size_t>( num_threads, n ) ) );
+    pool.parallel_for(n, f);
+}
+
+}
+}
+
+#endif // COPS_PARALLEL_HPP
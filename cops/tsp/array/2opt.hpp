@@ -0,0 +1,152 @@
+#ifndef TSP_2OPT_HPP
+#define TSP_2OPT_HPP
+
+#include "array.hpp"
+#include "array_tour.hpp"
+#include "two_level_tour.hpp"
+#include "improvement.hpp"
+#include "../candidates.hpp"
+#include "../distance.hpp"
+#include "onion/PerturbationOperator.hpp"
+
+namespace onion{
+namespace cops {
+namespace tsp {
+namespace array {
+
+// 2-opt kernel: searches the 2-opt moves that start at city a.
+//
+// A 2-opt move removes two edges and reconnects the tour the only other possible way
+// (see 2opt.txt for the index arithmetic on a path). Starting at city a:
+//
+// - succ direction: removes (a,next(a)) and (c,next(c)); adds (a,c) and (next(a),next(c))
+// - pred direction: removes (prev(a),a) and (prev(c),c); adds (a,c) and (prev(a),prev(c))
+//
+// c runs over the candidates of a, nearest first. Since the move must improve the tour, the new edge (a,c)
+// must be shorter than the removed edge at a (gain criterion), so the search stops at the first candidate
+// that is too far. The variation of the tour length is computed in O(1) with 4 distance reads.
+
+template< typename problem_data_t, typename tour_type = ArrayTour >
+class TwoOptKernel{
+public:
+
+    using cost_type = cost_t<problem_data_t>;
+
+    TwoOptKernel(const problem_data_t& data, const CandidateList& candidates, improvement_t mode):
+        _data(data),
+        _candidates(candidates),
+        _mode(mode){
+    }
+
+    // Applies the first (or best) improving move that starts at a and activates its end points.
+    // Returns the variation of the tour length, 0 if no improving move was found.
+    cost_type improve(tour_type& tour, ActiveQueue& queue, unsigned int a){
+        cost_type    best = 0;
+        unsigned int best_b = 0, best_c = 0, best_d = 0;
+        bool         best_succ = true;
+
+        for (int direction = 0; direction < 2; ++direction){
+            const bool         succ = ( direction == 0 );
+            const unsigned int b    = succ ? tour.next(a) : tour.prev(a);
+            const cost_type    d_ab = distance(_data, a, b);
+
+            for (auto it = _candidates.begin(a); it != _candidates.end(a); ++it){
+                const unsigned int c    = *it;
+                const cost_type    d_ac = distance(_data, a, c);
+                if ( d_ac >= d_ab ) break;
+
+                const unsigned int d = succ ? tour.next(c) : tour.prev(c);
+                if ( c == b || d == a ) continue;
+
+                const cost_type delta = d_ac + distance(_data, b, d) - d_ab - distance(_data, c, d);
+                if ( delta < best ){
+                    best = delta;
+                    best_b = b;  best_c = c;  best_d = d;  best_succ = succ;
+                    if ( _mode == improvement_t::first ) break;
+                }
+            }
+            if ( best < 0 && _mode == improvement_t::first ) break;
+        }
+        if ( best >= 0 ) return 0;
+
+        if ( best_succ ) tour.reverse(best_b, best_c);
+        else             tour.reverse(a, best_d);
+
+        queue.push(a);
+        queue.push(best_b);
+        queue.push(best_c);
+        queue.push(best_d);
+        return best;
+    }
+
+private:
+
+    const problem_data_t& _data;
+    const CandidateList&  _candidates;
+    improvement_t         _mode;
+};
+
+// 2-opt local search.
+//
+// Improves a path until no improving 2-opt move is left among the candidate edges (a 2-opt local optimum,
+// with respect to the candidate lists). Uses:
+//
+// - O(1) delta evaluation
+// - candidate neighbour lists (see ../candidates.hpp): O(k) moves examined per city instead of O(n)
+// - don't-look bits: only cities whose tour edges changed are examined again
+// - reversal of the shorter side of the tour (see ArrayTour), or O(sqrt(n)) reversals (see TwoLevelTour)
+//
+// The working tour and queue are allocated once, in the constructor, and reused by every call.
+//
+// problem_data_t : distance data, see ../distance.hpp
+// path_type      : path_t<num_cities>, tour_t<index_t> or any container with the same layout (see array.hpp)
+// tour_type      : working tour, ArrayTour or TwoLevelTour (see two_level_tour.hpp)
+
+template< typename problem_data_t, typename path_type, typename tour_type = ArrayTour >
+class TwoOpt : public onion::PerturbationOperator< path_type, path_type >
+{
+public:
+
+    using cost_type = cost_t<problem_data_t>;
+
+    TwoOpt(const problem_data_t& data, const CandidateList& candidates, improvement_t mode = improvement_t::first):
+        ComponentID( IDBuilder()
+                    .name("TwoOpt")
+                    .description("2-opt local search with neighbour lists and don't-look bits.")
+                    .type("Perturbation Operator")
+                    .version("v0.1.0")
+                    .problem("TSP")),
+        _kernel(data, candidates, mode),
+        _tour(candidates.size()),
+        _queue(candidates.size()){
+    }
+
+    // returns the 2-opt local optimum reached from S
+    virtual path_type operator()(const path_type& S){
+        path_type result = S;
+        improve(result);
+        return result;
+    }
+
+    // improves p in place; returns the variation of its length
+    cost_type improve(path_type& p){
+        _tour.load(p);
+        _queue.fill();
+        const cost_type delta = run_kernels<cost_type>(_tour, _queue, _kernel);
+        _tour.store(p);
+        return delta;
+    }
+
+private:
+
+    TwoOptKernel<problem_data_t, tour_type> _kernel;
+    tour_type                               _tour;
+    ActiveQueue                             _queue;
+};
+
+}
+}
+}
+}
+
+#endif // TSP_2OPT_HPP
@@ -1,16 +1,86 @@
 #ifndef ARRAY_HPP
 #define ARRAY_HPP
 
+#include "onion/AlignedAllocator.hpp"
 #include <array>
+#include <cstdint>
+#include <vector>
 
 namespace onion{
 namespace cops {
 namespace tsp {
 namespace array {
 
+// A path holds a hamiltonian cycle as the sequence of its cities, closed by repeating the first one:
+// |p| = num_cities + 1 and p[0] = p[num_cities] = 0. Every operator in this directory works on any
+// container with this layout (size(), operator[], begin() and end()).
+//
+// solution_t / path_t : the size is a template parameter; the path lives wherever its owner does
+//                       (large instances may overflow the stack when returned by value).
+// tour_t              : the size is known at runtime; the path lives on the heap, aligned to a cache line.
+//                       index_t is the type used to store a city: 16 bits halve the memory traffic
+//                       for instances of up to 65536 cities.
+
 template<unsigned int num_cities> using solution_t = std::array< unsigned int, num_cities + 1 >;
 template<unsigned int sz> using path_t = solution_t<sz>;
 
+template<typename index_t> using tour_t = std::vector< index_t, onion::AlignedAllocator<index_t> >;
+using tour16_t = tour_t<std::uint16_t>;
+using tour32_t = tour_t<std::uint32_t>;
+
+// Creates the path 0, 1, ... num_cities - 1, 0.
+// The size of a solution_t is fixed by its type: num_cities must match it.
+template<typename path_type>
+struct path_traits{
+    static path_type make(unsigned int num_cities){
+        return path_type(num_cities + 1);
+    }
+};
+
+template<typename index_t, std::size_t size>
+struct path_traits< std::array<index_t, size> >{
+    static std::array<index_t, size> make(unsigned int){
+        return std::array<index_t, size>();
+    }
+};
+
+template<typename path_type>
+inline path_type make_path(unsigned int num_cities){
+    path_type p = path_traits<path_type>::make(num_cities);
+    const unsigned int n = static_cast<unsigned int>( p.size() - 1 );
+    for (unsigned int k = 0; k < n; ++k) p[k] = k;
+    p[n] = 0;
+    return p;
+}
+
+// Creates the path that visits the cities in the cyclic order given by order, rotated to start at city 0.
+template<typename path_type>
+inline path_type to_path(const std::vector<unsigned int>& order){
+    const unsigned int n = static_cast<unsigned int>( order.size() );
+    path_type p = path_traits<path_type>::make(n);
+    unsigned int start = 0;
+    while ( start < n && order[start] != 0 ) ++start;
+    for (unsigned int k = 0; k < n; ++k) p[k] = order[ ( start + k ) % n ];
+    p[n] = 0;
+    return p;
+}
+
+// true if index_t can hold every city of an instance with num_cities cities
+template<typename index_t>
+constexpr bool fits_index(unsigned long long num_cities){
+    return num_cities == 0 || num_cities - 1 <= static_cast<unsigned long long>( index_t(~index_t(0)) );
+}
+
+// Calls f with the identity tour of num_cities cities, stored in the narrowest tour type that fits:
+// tour16_t up to 65536 cities, tour32_t otherwise. f is usually a generic lambda, instantiated for both:
+//
+//     with_tour(n, [&](auto tour){ ... });
+template<typename function_t>
+inline auto with_tour(unsigned int num_cities, function_t&& f){
+    if ( fits_index<std::uint16_t>(num_cities) ) return f( make_path<tour16_t>(num_cities) );
+    return f( make_path<tour32_t>(num_cities) );
+}
+
 }
 }
 }
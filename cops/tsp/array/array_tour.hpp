@@ -0,0 +1,113 @@
+#ifndef TSP_ARRAY_TOUR_HPP
+#define TSP_ARRAY_TOUR_HPP
+
+#include <utility>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace tsp {
+namespace array {
+
+// Working representation of a tour used by the improvement engines (2opt.hpp ...).
+//
+// A path (array.hpp) is convenient to store and evaluate a solution, but improvement moves need to know,
+// in O(1), where a city is and which cities follow and precede it. ArrayTour keeps the cyclic order of the
+// cities (without the closing element) and the inverse permutation (position of each city).
+//
+// Operations:
+//
+// next(c), prev(c)   : successor and predecessor of city c
+// between(a,b,c)     : true if b lies on the path that goes forward from a to c (inclusive)
+// reverse(a,b)       : reverses the path that goes forward from a to b (inclusive)
+//
+// reverse() flips whichever is shorter: the path a..b or the rest of the tour. Both produce the same cycle,
+// but the second one also changes its orientation. Engines must therefore read next() and prev() again
+// after each reverse(). The cost of a reversal is O(min(len, n - len)).
+
+class ArrayTour{
+public:
+
+    ArrayTour() = default;
+
+    explicit ArrayTour(unsigned int num_cities):
+        _order(num_cities),
+        _pos(num_cities){
+    }
+
+    unsigned int size() const noexcept { return static_cast<unsigned int>( _order.size() ); }
+
+    // Loads the first num_cities positions of a path (or of any sequence of cities).
+    template< typename path_type >
+    void load(const path_type& p){
+        const unsigned int n = size();
+        for (unsigned int k = 0; k < n; ++k){
+            _order[k]     = p[k];
+            _pos[ p[k] ]  = k;
+        }
+    }
+
+    // Stores the tour in a path that starts and ends at city 0.
+    template< typename path_type >
+    void store(path_type& p) const {
+        const unsigned int n = size();
+        unsigned int k = _pos[0];
+        for (unsigned int i = 0; i < n; ++i){
+            p[i] = _order[k];
+            if ( ++k == n ) k = 0;
+        }
+        p[n] = p[0];
+    }
+
+    unsigned int city(unsigned int position) const noexcept { return _order[position]; }
+    unsigned int position(unsigned int c)    const noexcept { return _pos[c]; }
+
+    unsigned int next(unsigned int c) const noexcept {
+        const unsigned int k = _pos[c] + 1;
+        return _order[ k == size() ? 0 : k ];
+    }
+
+    unsigned int prev(unsigned int c) const noexcept {
+        const unsigned int k = _pos[c];
+        return _order[ k == 0 ? size() - 1 : k - 1 ];
+    }
+
+    bool between(unsigned int a, unsigned int b, unsigned int c) const noexcept {
+        const unsigned int pa = _pos[a], pb = _pos[b], pc = _pos[c];
+        if ( pa <= pc ) return pa <= pb && pb <= pc;
+        return pb >= pa || pb <= pc;
+    }
+
+    void reverse(unsigned int a, unsigned int b) noexcept {
+        const unsigned int n = size();
+        unsigned int i = _pos[a], j = _pos[b];
+        unsigned int len = ( j >= i ? j - i : j + n - i ) + 1;
+
+        // the complement b+1 .. a-1 is shorter: reverse it instead
+        if ( 2 * len > n ){
+            i   = ( j + 1 == n ) ? 0 : j + 1;
+            j   = ( _pos[a] == 0 ) ? n - 1 : _pos[a] - 1;
+            len = n - len;
+        }
+
+        for (unsigned int s = len / 2; s > 0; --s){
+            const unsigned int ci = _order[i], cj = _order[j];
+            _order[i] = cj;  _pos[cj] = i;
+            _order[j] = ci;  _pos[ci] = j;
+            if ( ++i == n ) i = 0;
+            j = ( j == 0 ) ? n - 1 : j - 1;
+        }
+    }
+
+private:
+
+    std::vector<unsigned int> _order;
+    std::vector<unsigned int> _pos;
+};
+
+}
+}
+}
+}
+
+#endif // TSP_ARRAY_TOUR_HPP
@@ -1,87 +1,216 @@
-//#ifndef CREATE_GREEDY_HPP
-//#define CREATE_GREEDY_HPP
-
-//#include "array.hpp"
-//#include "../../../onion/create.hpp"
-
-//namespace onion{
-//namespace cops {
-//namespace tsp {
-//namespace array {
-
-//template<typename problem_data_t,unsigned int num_cities>
-//class CreateGreedy : public onion::CreateOperator< solution_t<num_cities> >
-//{
-//public:
-
-//    CreateGreedy(const problem_data_t& data):
-//        _data(data),
-//        Component( SetComponent()
-//                    .name("CreateGreedy")
-//                    .description("Starts at a random city then move to the closest city recursively until all cities are visited.")
-//                    .type("Create Operator")
-//                    .version("v0.1.0")
-//                    .problem("TSP")
-//                    .solution_type("unsigned int[]")
-//                   ){
-
-//    }
-
-//    virtual solution_t<num_cities> operator()(void){
-
-//        // creates a path, always choosing the closest city available
-//        static const unsigned  n = static_cast<unsigned>( _data.size() );
-//        static solution_t<num_cities>          visited(n+1,0);
-
-//        auto city       = onion::rand_between(0,n-1);
-//        visited.at(0)   = city;
-
-//        for(unsigned i = 1; i < n; i++){
-//            // get the city that has, at the same time,
-//            //the minimum travel cost and was not visited yet
-//            unsigned least_cost         = std::numeric_limits<unsigned>::max();
-//            unsigned least_cost_city    = 0;
-
-//            for(unsigned j = 0; j < n; j++){
-//               auto end = visited.begin()+i;
-//               if ( std::find(visited.begin(), end, j ) != end ) continue; // O(N)!! can be O(1)
-
-//               if ( _data.at(city).at(j) < least_cost ){
-//                   least_cost = _data.at(city).at(j);
-//                   least_cost_city = j;
-//               }
-//            }
-//            visited.at(i)   = least_cost_city;
-//            city            = least_cost_city;
-//        }
-
-//        static path_t res(n+1,0);
-
-//        // path starts at a random city.
-//        // This puts back in the 0 starting standard
-//        // this is just me being afraid of some algorithm
-//        // relying on paths starting always at city 0
-
-//        // CONSIDER REMOVING
-
-//        if ( visited.at(0) != 0 ){
-
-//            auto it = std::find(visited.begin(),visited.end(),0);
-//            auto len = std::distance(it,visited.end());
-
-//            std::copy(it,visited.end(),res.begin());
-//            std::copy(visited.begin(),it,res.begin()+len-1);
-//        }
-//        else{
-//            res = visited;
-//        }
-
-//        return res;
-
-//    }
-//private:
-
-//    problem_data_t _data;
-//};
-
-//#endif // CREATE_GREEDY_HPP
+#ifndef CREATE_GREEDY_HPP
+#define CREATE_GREEDY_HPP
+
+#include "array.hpp"
+#include "../candidate_builder.hpp"
+#include "../candidates.hpp"
+#include "../coordinates.hpp"
+#include "../hilbert.hpp"
+#include "../kdtree.hpp"
+#include "onion/CreateOperator.hpp"
+#include "onion/Random.hpp"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace tsp {
+namespace array {
+
+// Tour construction heuristics for instances given by coordinates (see ../coordinates.hpp).
+//
+// All of them run in O(n log n): the searches for near cities go through a k-d tree (see ../kdtree.hpp)
+// instead of scanning every city. Typical tour lengths above the optimum on uniform random instances:
+// space-filling curve 40%, nearest neighbour 25%, greedy edge 16-20%. The paths they create start at city 0
+// (see array.hpp).
+//
+// path_type : path_t<num_cities>, tour_t<index_t> or any container with the same layout (see array.hpp)
+
+// Starts at a random city and moves to the nearest city not visited yet, until all cities are visited.
+template<typename path_type>
+class CreateNearestNeighbour : public onion::CreateOperator< path_type >
+{
+public:
+
+    CreateNearestNeighbour(const CoordinateDistance& coordinates):
+        ComponentID( IDBuilder()
+                    .name("CreateNearestNeighbour")
+                    .description("Starts at a random city then move to the closest city recursively until all cities are visited.")
+                    .type("Create Operator")
+                    .version("v0.1.0")
+                    .problem("TSP")),
+        _tree( coordinates.x(), coordinates.y(), coordinates.size() ),
+        _order( coordinates.size() ){
+    }
+
+    virtual path_type operator()(void){
+        const unsigned int n = _tree.size();
+        if ( n == 0 ) return to_path<path_type>(_order);
+
+        _tree.reset();
+        unsigned int city = onion::Random().uniform_int_between(0, n - 1);
+        for (unsigned int k = 0; k < n; ++k){
+            _order[k] = city;
+            _tree.erase(city);
+            if ( k + 1 < n ) city = _tree.nearest(city);
+        }
+        return to_path<path_type>(_order);
+    }
+
+private:
+
+    KdTree                    _tree;
+    std::vector<unsigned int> _order;
+};
+
+// Greedy edge (or greedy matching) construction: edges are taken in increasing length as long as no city gets
+// more than two of them and no cycle is closed before the end.
+//
+// Only the edges to the candidates of each city are considered: the lists given to the constructor, or the
+// 10 nearest neighbours of each city (see ../candidate_builder.hpp). The fragments left when they run out are
+// joined as in the nearest neighbour heuristic, from fragment end to the nearest end of another fragment.
+// The result does not depend on the random engine.
+template<typename path_type>
+class CreateGreedyEdge : public onion::CreateOperator< path_type >
+{
+public:
+
+    CreateGreedyEdge(const CoordinateDistance& coordinates, unsigned int k = 10):
+        ComponentID( IDBuilder()
+                    .name("CreateGreedyEdge")
+                    .description("Adds the shortest edges that keep a set of paths, then joins the paths.")
+                    .type("Create Operator")
+                    .version("v0.1.0")
+                    .problem("TSP")),
+        _coordinates(coordinates),
+        _own_candidates( kd_nearest_neighbours(coordinates, k) ),
+        _candidates(_own_candidates){
+    }
+
+    // the candidate lists are not copied and must outlive the operator
+    CreateGreedyEdge(const CoordinateDistance& coordinates, const CandidateList& candidates):
+        ComponentID( IDBuilder()
+                    .name("CreateGreedyEdge")
+                    .description("Adds the shortest edges that keep a set of paths, then joins the paths.")
+                    .type("Create Operator")
+                    .version("v0.1.0")
+                    .problem("TSP")),
+        _coordinates(coordinates),
+        _candidates(candidates){
+    }
+
+    // _candidates may refer to _own_candidates: a copy would refer to the lists of the original
+    CreateGreedyEdge(const CreateGreedyEdge&) = delete;
+    CreateGreedyEdge& operator=(const CreateGreedyEdge&) = delete;
+
+    virtual path_type operator()(void){
+        const unsigned int n = _coordinates.size();
+        if ( n < 3 ) return make_path<path_type>(n);
+
+        KdTree tree( _coordinates.x(), _coordinates.y(), n );
+
+        // candidate edges (i < j), shortest first
+        std::vector< std::pair<double, std::pair<unsigned int, unsigned int> > > edges;
+        edges.reserve( _candidates.num_neighbours() );
+        for (unsigned int i = 0; i < n; ++i){
+            for (auto it = _candidates.begin(i); it != _candidates.end(i); ++it){
+                const unsigned int a = std::min(i, *it), b = std::max(i, *it);
+                if ( a != b ) edges.push_back( std::make_pair( tree.distance2(a, b), std::make_pair(a, b) ) );
+            }
+        }
+        std::sort( edges.begin(), edges.end() );
+        edges.erase( std::unique( edges.begin(), edges.end() ), edges.end() );
+
+        // adjacency of the fragments, and the other end of the fragment of each end point
+        std::vector<unsigned int> adjacent( 2 * std::size_t(n), KdTree::none );
+        std::vector<unsigned int> other_end(n);
+        for (unsigned int c = 0; c < n; ++c) other_end[c] = c;
+
+        for (const auto& e : edges){
+            const unsigned int a = e.second.first, b = e.second.second;
+            if ( degree(adjacent, a) == 2 || degree(adjacent, b) == 2 || other_end[a] == b ) continue;
+            const unsigned int ea = other_end[a], eb = other_end[b];
+            link(adjacent, a, b);
+            other_end[ea] = eb;
+            other_end[eb] = ea;
+        }
+
+        // joins the fragments: only their end points stay in the tree
+        for (unsigned int c = 0; c < n; ++c) if ( degree(adjacent, c) == 2 ) tree.erase(c);
+
+        unsigned int start = 0;
+        while ( degree(adjacent, start) == 2 ) ++start;  // there is at least one fragment end
+        unsigned int end = other_end[start];
+        tree.erase(start);
+        tree.erase(end);
+        while ( tree.active() ){
+            const unsigned int next = tree.nearest(end);
+            const unsigned int next_end = other_end[next];
+            link(adjacent, end, next);
+            tree.erase(next);
+            tree.erase(next_end);
+            end = next_end;
+        }
+        link(adjacent, end, start);
+
+        // walks the cycle
+        std::vector<unsigned int> order(n);
+        unsigned int previous = KdTree::none, city = 0;
+        for (unsigned int k = 0; k < n; ++k){
+            order[k] = city;
+            const unsigned int next = adjacent[2 * city] != previous ? adjacent[2 * city] : adjacent[2 * city + 1];
+            previous = city;
+            city     = next;
+        }
+        return to_path<path_type>(order);
+    }
+
+private:
+
+    static unsigned int degree(const std::vector<unsigned int>& adjacent, unsigned int c) noexcept {
+        return ( adjacent[2 * c] != KdTree::none ) + ( adjacent[2 * c + 1] != KdTree::none );
+    }
+
+    static void link(std::vector<unsigned int>& adjacent, unsigned int a, unsigned int b) noexcept {
+        adjacent[ 2 * a + ( adjacent[2 * a] != KdTree::none ) ] = b;
+        adjacent[ 2 * b + ( adjacent[2 * b] != KdTree::none ) ] = a;
+    }
+
+    const CoordinateDistance& _coordinates;
+    CandidateList             _own_candidates;
+    const CandidateList&      _candidates;
+};
+
+// Visits the cities in the order of a Hilbert curve laid over the instance (see ../hilbert.hpp).
+// The fastest construction, and the result does not depend on the random engine.
+template<typename path_type>
+class CreateSpaceFillingCurve : public onion::CreateOperator< path_type >
+{
+public:
+
+    CreateSpaceFillingCurve(const CoordinateDistance& coordinates):
+        ComponentID( IDBuilder()
+                    .name("CreateSpaceFillingCurve")
+                    .description("Visits the cities in the order of a Hilbert curve.")
+                    .type("Create Operator")
+                    .version("v0.1.0")
+                    .problem("TSP")),
+        _coordinates(coordinates){
+    }
+
+    virtual path_type operator()(void){
+        return to_path<path_type>( hilbert_order( _coordinates.x(), _coordinates.y(), _coordinates.size() ) );
+    }
+
+private:
+
+    const CoordinateDistance& _coordinates;
+};
+
+}
+}
+}
+}
+
+#endif // CREATE_GREEDY_HPP
@@ -2,7 +2,9 @@
 #define TSP_CREATE_RANDOM_HPP
 
 #include "array.hpp"
-#include "../../../onion/CreateOperator.hpp"
+#include "onion/CreateOperator.hpp"
+#include "onion/Random.hpp"
+#include <utility>
 
 namespace onion{
 namespace cops {
@@ -14,26 +16,39 @@ namespace array {
 // The extra element is used to close the cycle. i.e:
 // sol[0] = 0 and sol[ |sol| ] = 0 always
 // This makes computations simpler to represent and understand
+//
+// path_type : path_t<num_cities>, tour_t<index_t> or any container with the same layout (see array.hpp)
 
-template<unsigned int num_cities>
-class CreateRandom : public onion::CreateOperator< path_t< num_cities > >
+template<typename path_type>
+class CreateRandom : public onion::CreateOperator< path_type >
 {
 public:
 
-    CreateRandom():
-        Component( SetComponent()
+    CreateRandom(unsigned int num_cities):
+        ComponentID( IDBuilder()
                     .name("CreateRandom")
                     .description("Creates a random hamiltonian cycle.")
                     .type("Create Operator")
                     .version("v0.1.0")
-                    .problem("TSP")
-                    .solution_type("unsigned int[]")){
+                    .problem("TSP")),
+        _num_cities(num_cities){
     }
 
-    virtual path_t<num_cities> operator()(void){
-
+    // uniform shuffle (Fisher-Yates) of the cities 1 .. num_cities - 1, drawn from onion::Random()
+    virtual path_type operator()(void){
+        path_type p = make_path<path_type>(_num_cities);
+        auto& rng = onion::Random();
+        const unsigned int n = static_cast<unsigned int>( p.size() - 1 );
+        for (unsigned int k = n - 1; n > 2 && k > 1; --k){
+            const unsigned int r = rng.uniform_int_between(1, k);
+            std::swap( p[k], p[r] );
+        }
+        return p;
     }
 
+private:
+
+    unsigned int _num_cities;
 };
 
 }
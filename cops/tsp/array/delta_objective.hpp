@@ -0,0 +1,132 @@
+#ifndef TSP_DELTA_OBJECTIVE_HPP
+#define TSP_DELTA_OBJECTIVE_HPP
+
+#include "array.hpp"
+#include "moves.hpp"
+#include "../distance.hpp"
+#include "onion/DeltaObjective.hpp"
+
+namespace onion{
+namespace cops {
+namespace tsp {
+namespace array {
+
+// Delta objective functions for the moves in moves.hpp.
+// Each one reads at most 8 distances, whatever the number of cities: O(1) per evaluated neighbour,
+// instead of the O(n) of a TourLength call on the transformed path.
+//
+// problem_data_t : distance data, see ../distance.hpp
+// path_type      : path_t<num_cities>, tour_t<index_t> or any container with the same layout (see array.hpp)
+
+template< typename problem_data_t, typename path_type >
+class DeltaTwoOpt : public onion::DeltaObjective< path_type, two_opt_t, cost_t<problem_data_t> >
+{
+public:
+
+    DeltaTwoOpt(const problem_data_t& data):
+        ComponentID( IDBuilder()
+                    .name("DeltaTwoOpt")
+                    .description("Variation of the tour length caused by a 2-opt move.")
+                    .type("Delta Objective")
+                    .version("v0.1.0")
+                    .problem("TSP")),
+        _data(data){
+    }
+
+    virtual cost_t<problem_data_t> operator()(const path_type& p, const two_opt_t& m){
+        return delta(_data, p, m);
+    }
+
+    static inline cost_t<problem_data_t> delta(const problem_data_t& data, const path_type& p, const two_opt_t& m){
+        const auto a = p[m.i], b = p[m.i+1], c = p[m.j], d = p[m.j+1];
+        return cost_t<problem_data_t>( distance(data,a,c) ) + distance(data,b,d)
+             - distance(data,a,b) - distance(data,c,d);
+    }
+
+private:
+
+    const problem_data_t& _data;
+};
+
+template< typename problem_data_t, typename path_type >
+class DeltaSwap : public onion::DeltaObjective< path_type, swap_t, cost_t<problem_data_t> >
+{
+public:
+
+    DeltaSwap(const problem_data_t& data):
+        ComponentID( IDBuilder()
+                    .name("DeltaSwap")
+                    .description("Variation of the tour length caused by swapping two cities.")
+                    .type("Delta Objective")
+                    .version("v0.1.0")
+                    .problem("TSP")),
+        _data(data){
+    }
+
+    virtual cost_t<problem_data_t> operator()(const path_type& p, const swap_t& m){
+        return delta(_data, p, m);
+    }
+
+    static inline cost_t<problem_data_t> delta(const problem_data_t& data, const path_type& p, const swap_t& m){
+        const auto x = p[m.i], y = p[m.j];
+        const auto a = p[m.i-1], b = p[m.j+1];
+
+        // adjacent cities: the edge x-y is kept
+        if ( m.j == m.i + 1 ){
+            return cost_t<problem_data_t>( distance(data,a,y) ) + distance(data,x,b)
+                 - distance(data,a,x) - distance(data,y,b);
+        }
+        const auto xn = p[m.i+1], yp = p[m.j-1];
+        return cost_t<problem_data_t>( distance(data,a,y) ) + distance(data,y,xn)
+             + distance(data,yp,x) + distance(data,x,b)
+             - distance(data,a,x) - distance(data,x,xn)
+             - distance(data,yp,y) - distance(data,y,b);
+    }
+
+private:
+
+    const problem_data_t& _data;
+};
+
+template< typename problem_data_t, typename path_type >
+class DeltaInsertion : public onion::DeltaObjective< path_type, insertion_t, cost_t<problem_data_t> >
+{
+public:
+
+    DeltaInsertion(const problem_data_t& data):
+        ComponentID( IDBuilder()
+                    .name("DeltaInsertion")
+                    .description("Variation of the tour length caused by moving a city to another position.")
+                    .type("Delta Objective")
+                    .version("v0.1.0")
+                    .problem("TSP")),
+        _data(data){
+    }
+
+    virtual cost_t<problem_data_t> operator()(const path_type& p, const insertion_t& m){
+        return delta(_data, p, m);
+    }
+
+    static inline cost_t<problem_data_t> delta(const problem_data_t& data, const path_type& p, const insertion_t& m){
+        const auto c = p[m.from];
+        const auto a = p[m.from-1], b = p[m.from+1];
+
+        // after removing c, it is inserted between u and v, which are adjacent in the reduced path
+        const auto u = m.to > m.from ? p[m.to]   : p[m.to-1];
+        const auto v = m.to > m.from ? p[m.to+1] : p[m.to];
+
+        return cost_t<problem_data_t>( distance(data,a,b) ) - distance(data,a,c) - distance(data,c,b)
+             + distance(data,u,c) + distance(data,c,v) - distance(data,u,v);
+    }
+
+private:
+
+    const problem_data_t& _data;
+};
+
+}
+}
+}
+}
+
+#endif // TSP_DELTA_OBJECTIVE_HPP
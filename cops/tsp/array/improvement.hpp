@@ -0,0 +1,172 @@
+#ifndef TSP_IMPROVEMENT_HPP
+#define TSP_IMPROVEMENT_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace tsp {
+namespace array {
+
+// Common machinery of the improvement engines (2opt.hpp ...).
+//
+// An engine is made of one or more kernels. A kernel searches the moves that start at a given city,
+// using its candidate list, and applies the first (or best) improving one to the working tour
+// (ArrayTour, or TwoLevelTour for large instances).
+// The cities whose neighbourhood may still contain improving moves are kept in an ActiveQueue:
+// this is the classical don't-look bits scheme, where a city is "looked at" again only
+// when one of its tour edges changes.
+
+enum class improvement_t{
+    first,  // apply the first improving move found for a city
+    best    // apply the best improving move among those that start at a city
+};
+
+// FIFO of active cities. A city is in the queue at most once: its don't-look bit is off while it is queued.
+class ActiveQueue{
+public:
+
+    ActiveQueue() = default;
+
+    explicit ActiveQueue(unsigned int num_cities):
+        _queue(num_cities),
+        _queued(num_cities, false){
+    }
+
+    unsigned int size() const noexcept { return static_cast<unsigned int>( _queued.size() ); }
+    bool         empty() const noexcept { return _count == 0; }
+
+    // activates all cities, in order
+    void fill() noexcept {
+        _head = _count = 0;
+        for (unsigned int c = 0; c < size(); ++c) push(c);
+    }
+
+    // activates city c (turns its don't-look bit off)
+    void push(unsigned int c) noexcept {
+        if ( _queued[c] ) return;
+        _queued[c] = true;
+        unsigned int tail = _head + _count;
+        if ( tail >= size() ) tail -= size();
+        _queue[tail] = c;
+        ++_count;
+    }
+
+    unsigned int pop() noexcept {
+        const unsigned int c = _queue[_head];
+        if ( ++_head == size() ) _head = 0;
+        --_count;
+        _queued[c] = false;
+        return c;
+    }
+
+private:
+
+    std::vector<unsigned int> _queue;
+    std::vector<bool>         _queued;
+    unsigned int              _head  = 0;
+    unsigned int              _count = 0;
+};
+
+// Reverses the path first..last of a tour, given a city outside the path that is adjacent to first.
+// Tours may change orientation after a reversal (see ArrayTour), so the direction of the path is
+// found again from its neighbourhood: it goes forward if next(outside) == first.
+template< typename tour_type >
+inline void reverse_path(tour_type& tour, unsigned int outside, unsigned int first, unsigned int last){
+    if ( tour.next(outside) == first ) tour.reverse(first, last);
+    else                               tour.reverse(last, first);
+}
+
+// A working tour that can record its reversals and undo them, newest first.
+//
+// A reversal of the path a..b replaces the edges (p, a) and (b, q) by (p, b) and (a, q), p being the city
+// before a: it is undone by reversing the path b..a that now follows p. Only (p, a, b) is recorded, so an
+// undo costs what the reversals cost, O(sqrt(n)) each on a TwoLevelTour, where restoring a copy of the
+// tour costs O(n). The kernels take an UndoableTour< tour_type > as their tour_type.
+template< typename tour_type >
+class UndoableTour : public tour_type{
+public:
+
+    using tour_type::tour_type;
+
+    void reverse(unsigned int a, unsigned int b){
+        if ( _recording ){
+            // a reversal that undoes the last recorded one (LK steps that are rolled back) cancels it
+            if ( !_log.empty() && cancels( _log.back(), a, b ) ) _log.pop_back();
+            // a..b covering the whole tour only changes the orientation: nothing to undo
+            else if ( tour_type::next(b) != a ) _log.push_back( reversal_t{ tour_type::prev(a), a, b } );
+        }
+        tour_type::reverse(a, b);
+    }
+
+    // Starts recording, with an empty record.
+    void record(){
+        _log.clear();
+        _recording = true;
+    }
+
+    // Stops recording and keeps the changes.
+    void commit(){
+        _log.clear();
+        _recording = false;
+    }
+
+    // Stops recording and undoes the recorded reversals.
+    void undo(){
+        tour_type& tour = *this;
+        for (std::size_t k = _log.size(); k-- > 0; ) reverse_path( tour, _log[k].p, _log[k].b, _log[k].a );
+        _log.clear();
+        _recording = false;
+    }
+
+private:
+
+    struct reversal_t{
+        unsigned int p, a, b;
+    };
+
+    // true if reversing a..b removes the edges (p, r.b) and (r.a, q) that r added
+    bool cancels(const reversal_t& r, unsigned int a, unsigned int b) const {
+        return ( a == r.b && b == r.a && tour_type::prev(a) == r.p ) ||
+               ( a == r.a && b == r.b && tour_type::next(b) == r.p );
+    }
+
+    std::vector<reversal_t> _log;
+    bool                    _recording = false;
+};
+
+// Runs the kernels until no city is active. For each active city the kernels are tried in order;
+// as soon as one of them improves the tour, the city is activated again (the kernel does it) and
+// the next active city is processed. This is how 2-opt and Or-opt moves are interleaved in a single pass.
+// Returns the total variation of the tour length (negative or zero).
+
+template< typename cost_type, typename tour_type >
+inline cost_type first_improving(tour_type&, ActiveQueue&, unsigned int){
+    return cost_type(0);
+}
+
+template< typename cost_type, typename tour_type, typename kernel_type, typename... kernels_type >
+inline cost_type first_improving(tour_type& tour, ActiveQueue& queue, unsigned int c,
+                                 kernel_type& kernel, kernels_type&... kernels){
+    const cost_type delta = kernel.improve(tour, queue, c);
+    if ( delta < 0 ) return delta;
+    return first_improving<cost_type>(tour, queue, c, kernels...);
+}
+
+template< typename cost_type, typename tour_type, typename... kernels_type >
+cost_type run_kernels(tour_type& tour, ActiveQueue& queue, kernels_type&... kernels){
+    cost_type total = 0;
+    while ( !queue.empty() ){
+        const unsigned int c = queue.pop();
+        total += first_improving<cost_type>(tour, queue, c, kernels...);
+    }
+    return total;
+}
+
+}
+}
+}
+}
+
+#endif // TSP_IMPROVEMENT_HPP
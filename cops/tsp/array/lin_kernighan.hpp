@@ -0,0 +1,310 @@
+#ifndef TSP_LIN_KERNIGHAN_HPP
+#define TSP_LIN_KERNIGHAN_HPP
+
+#include "array.hpp"
+#include "array_tour.hpp"
+#include "two_level_tour.hpp"
+#include "improvement.hpp"
+#include "oropt.hpp"
+#include "../candidates.hpp"
+#include "../distance.hpp"
+#include "onion/PerturbationOperator.hpp"
+#include "onion/Random.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace tsp {
+namespace array {
+
+// Search limits of the Lin-Kernighan kernel.
+struct lk_parameters_t{
+    // maximum number of 2-opt steps in a chain
+    unsigned int max_depth = 50;
+    // number of alternatives tried at the first levels of the chain (backtracking);
+    // deeper levels try a single alternative
+    std::vector<unsigned int> breadth = { 5, 3 };
+};
+
+// Lin-Kernighan kernel: variable-depth search that starts at city t1.
+//
+// The chain is built from 2-opt steps, as in Applegate, Bixby, Chvatal and Cook's LK implementation.
+// Each step removes the edge (t1,t2) and an edge (t3,t4), adds (t2,t3) and (t4,t1), and continues from
+// (t1,t4) as the new (t1,t2):
+//
+// - t3 runs over the candidates of t2, subject to the gain criterion: the partial gain
+//   G = sum(removed) - sum(added), without the closing edge (t4,t1), must stay positive.
+// - alternatives are ranked by G - d(t2,t3) + d(t3,t4) (one step lookahead); breadth[level] of them are
+//   tried at each of the first levels, a single one deeper.
+// - an edge added by the chain is never removed again and a removed edge is never added back.
+// - the chain stops at max_depth steps or when G cannot beat the best improvement found so far.
+//
+// The tour is changed as the chain grows. At the end it is rolled back to the step with the best tour length;
+// if that is not an improvement the tour is left unchanged. Steps are applied with reversals (see
+// reverse_path), so the kernel works on any tour type that provides next, prev and reverse.
+
+template< typename problem_data_t, typename tour_type = ArrayTour >
+class LinKernighanKernel{
+public:
+
+    using cost_type = cost_t<problem_data_t>;
+
+    LinKernighanKernel(const problem_data_t& data, const CandidateList& candidates,
+                       const lk_parameters_t& parameters = lk_parameters_t()):
+        _data(data),
+        _candidates(candidates),
+        _parameters(parameters){
+        _steps.reserve(_parameters.max_depth);
+        _alternatives.resize( _parameters.max_depth + 1 );
+    }
+
+    const problem_data_t& data() const noexcept { return _data; }
+
+    // Applies the best chain found from t1 and activates the cities it touches.
+    // Returns the variation of the tour length, 0 if no improving chain was found.
+    cost_type improve(tour_type& tour, ActiveQueue& queue, unsigned int t1){
+        if ( tour.size() < 8 ) return 0;
+
+        for (int side = 0; side < 2; ++side){
+            const unsigned int t2 = ( side == 0 ) ? tour.next(t1) : tour.prev(t1);
+
+            _t1         = t1;
+            _best_delta = 0;
+            _best_depth = 0;
+            _steps.clear();
+
+            if ( search(tour, 0, t2, distance(_data, t1, t2), 0) ){
+                for (const auto& s : _steps){
+                    queue.push(s.t2);
+                    queue.push(s.t3);
+                    queue.push(s.t4);
+                }
+                queue.push(t1);
+                return _best_delta;
+            }
+        }
+        return 0;
+    }
+
+private:
+
+    struct step_t{
+        unsigned int t2, t3, t4;
+    };
+
+    struct alternative_t{
+        unsigned int t3, t4;
+        cost_type    rank;
+    };
+
+    // true if the edge (a,b) was added by the current chain
+    bool added(unsigned int a, unsigned int b) const {
+        for (const auto& s : _steps){
+            if ( ( s.t2 == a && s.t3 == b ) || ( s.t2 == b && s.t3 == a ) ) return true;
+        }
+        return false;
+    }
+
+    // true if the edge (a,b) was removed by the current chain (closing edges excluded)
+    bool removed(unsigned int a, unsigned int b) const {
+        for (const auto& s : _steps){
+            if ( ( s.t3 == a && s.t4 == b ) || ( s.t3 == b && s.t4 == a ) ) return true;
+        }
+        if ( !_steps.empty() ){
+            const unsigned int t2 = _steps.front().t2;
+            if ( ( _t1 == a && t2 == b ) || ( _t1 == b && t2 == a ) ) return true;
+        }
+        return false;
+    }
+
+    // Extends the chain from the current (t1,t2). gain is G before choosing y = (t2,t3),
+    // delta is the variation of the tour length caused by the steps already applied.
+    // Returns true if an improving chain was found; the tour is then left at its best step.
+    bool search(tour_type& tour, unsigned int level, unsigned int t2, cost_type gain, cost_type delta){
+        const bool     forward = ( tour.next(_t1) == t2 );
+        auto&          alternatives = _alternatives[level];
+        const unsigned breadth = level < _parameters.breadth.size() ? _parameters.breadth[level] : 1;
+
+        alternatives.clear();
+        for (auto it = _candidates.begin(t2); it != _candidates.end(t2); ++it){
+            const unsigned int t3 = *it;
+            const cost_type    g1 = gain - distance(_data, t2, t3);
+            if ( g1 <= 0 ) break;
+            if ( t3 == _t1 ) continue;
+
+            // t4 is the neighbour of t3 on the side of t2, so that the step keeps a hamiltonian cycle
+            const unsigned int t4 = forward ? tour.prev(t3) : tour.next(t3);
+            if ( t4 == t2 || t3 == t2 ) continue;
+            if ( removed(t2, t3) || added(t3, t4) ) continue;
+
+            alternatives.push_back( alternative_t{ t3, t4, g1 + distance(_data, t3, t4) } );
+        }
+        if ( alternatives.empty() ) return finish(tour);
+
+        const auto last = alternatives.begin() + std::min<std::size_t>( breadth, alternatives.size() );
+        std::partial_sort( alternatives.begin(), last, alternatives.end(),
+                           [](const alternative_t& a, const alternative_t& b){ return a.rank > b.rank; } );
+
+        for (auto it = alternatives.begin(); it != last; ++it){
+            const unsigned int t3 = it->t3, t4 = it->t4;
+            const cost_type    g  = it->rank;      // G after removing (t3,t4)
+            const cost_type    d_t4t1 = distance(_data, t4, _t1);
+            const cost_type    step_delta = cost_type( distance(_data, t2, t3) ) + d_t4t1
+                                          - distance(_data, _t1, t2) - distance(_data, t3, t4);
+
+            reverse_path(tour, _t1, t2, t4);
+            _steps.push_back( step_t{ t2, t3, t4 } );
+
+            const cost_type new_delta = delta + step_delta;
+            if ( new_delta < _best_delta ){
+                _best_delta = new_delta;
+                _best_depth = static_cast<unsigned int>( _steps.size() );
+            }
+
+            const bool deeper = _steps.size() < _parameters.max_depth && g > -_best_delta;
+            if ( deeper ? search(tour, level + 1, t4, g, new_delta) : finish(tour) ) return true;
+
+            // no improvement below this step: undo it and try the next alternative
+            _steps.pop_back();
+            reverse_path(tour, _t1, t4, t2);
+            if ( _best_depth > _steps.size() ) _best_depth = static_cast<unsigned int>( _steps.size() );
+        }
+        return false;
+    }
+
+    // End of a chain: rolls the tour back to the best step, if there is an improvement.
+    bool finish(tour_type& tour){
+        if ( _best_delta >= 0 ) return false;
+        while ( _steps.size() > _best_depth ){
+            const step_t s = _steps.back();
+            _steps.pop_back();
+            reverse_path(tour, _t1, s.t4, s.t2);
+        }
+        return true;
+    }
+
+    const problem_data_t&                    _data;
+    const CandidateList&                     _candidates;
+    lk_parameters_t                          _parameters;
+
+    unsigned int                             _t1 = 0;
+    cost_type                                _best_delta = 0;
+    unsigned int                             _best_depth = 0;
+    std::vector<step_t>                      _steps;
+    std::vector< std::vector<alternative_t> > _alternatives;
+};
+
+// Lin-Kernighan style local search.
+//
+// Runs the Lin-Kernighan kernel interleaved with Or-opt moves (which a chain of 2-opt steps
+// cannot always reach) until no active city is left. Same machinery as TwoOpt: candidate lists,
+// don't-look bits and a working tour allocated once.
+//
+// problem_data_t : distance data, see ../distance.hpp
+// path_type      : path_t<num_cities>, tour_t<index_t> or any container with the same layout (see array.hpp)
+// tour_type      : working tour, ArrayTour or TwoLevelTour (see two_level_tour.hpp)
+
+template< typename problem_data_t, typename path_type, typename tour_type = ArrayTour >
+class LinKernighan : public onion::PerturbationOperator< path_type, path_type >
+{
+public:
+
+    using cost_type = cost_t<problem_data_t>;
+
+    LinKernighan(const problem_data_t& data, const CandidateList& candidates,
+                 const lk_parameters_t& parameters = lk_parameters_t()):
+        ComponentID( IDBuilder()
+                    .name("LinKernighan")
+                    .description("Variable-depth Lin-Kernighan local search with Or-opt moves.")
+                    .type("Perturbation Operator")
+                    .version("v0.1.0")
+                    .problem("TSP")),
+        _lin_kernighan(data, candidates, parameters),
+        _or_opt(data, candidates, improvement_t::first),
+        _tour(candidates.size()),
+        _queue(candidates.size()){
+    }
+
+    virtual path_type operator()(const path_type& S){
+        path_type result = S;
+        improve(result);
+        return result;
+    }
+
+    cost_type improve(path_type& p){
+        _tour.load(p);
+        _queue.fill();
+        const cost_type delta = run_kernels<cost_type>(_tour, _queue, _lin_kernighan, _or_opt);
+        _tour.store(p);
+        return delta;
+    }
+
+    // Iterated Lin-Kernighan: improves p and then applies kicks. Each kick is a segment-local double-bridge
+    // (two short consecutive segments swap places, a move that LK chains hardly undo), followed by a local search
+    // restricted to the cities it touched. A kick is kept if the tour gets shorter, otherwise it is reverted.
+    // The working tour records the reversals of the kick and of its local search (see UndoableTour), and a
+    // rejected kick undoes them: a kick never costs O(n), so kicks stay cheap on a TwoLevelTour.
+    // Kicks use the onion::Random() engine. Returns the variation of the length of p.
+    cost_type optimize(path_type& p, unsigned int kicks, unsigned int max_segment = 50){
+        _tour.load(p);
+        _queue.fill();
+        cost_type delta = run_kernels<cost_type>(_tour, _queue, _lin_kernighan, _or_opt);
+
+        const unsigned int n = _tour.size();
+        max_segment = std::min( max_segment, ( n - 2 ) / 3 );
+        if ( !max_segment ) kicks = 0;
+
+        for (unsigned int k = 0; k < kicks; ++k){
+            _tour.record();
+            const cost_type kick = double_bridge( max_segment );
+            const cost_type local = run_kernels<cost_type>(_tour, _queue, _lin_kernighan, _or_opt);
+            if ( kick + local < 0 ){
+                delta += kick + local;
+                _tour.commit();
+            }
+            else _tour.undo();
+        }
+        _tour.store(p);
+        return delta;
+    }
+
+private:
+
+    // Swaps the segments b1..b2 and c1..c2 that follow city a: a [b1..b2] [c1..c2] d -> a [c1..c2] [b1..b2] d.
+    // Activates the six cities involved and returns the variation of the tour length.
+    cost_type double_bridge(unsigned int max_segment){
+        auto& rng = onion::Random();
+        const unsigned int a  = rng.uniform_int_between(0, _tour.size() - 1);
+        const unsigned int b1 = _tour.next(a);
+        unsigned int b2 = b1;
+        for (unsigned int k = rng.uniform_int_between(1, max_segment); k > 1; --k) b2 = _tour.next(b2);
+        const unsigned int c1 = _tour.next(b2);
+        unsigned int c2 = c1;
+        for (unsigned int k = rng.uniform_int_between(1, max_segment); k > 1; --k) c2 = _tour.next(c2);
+        const unsigned int d  = _tour.next(c2);
+
+        const auto& data = _lin_kernighan.data();
+        const cost_type delta = cost_type( distance(data, a, c1) ) + distance(data, c2, b1) + distance(data, b2, d)
+                              - distance(data, a, b1) - distance(data, b2, c1) - distance(data, c2, d);
+
+        reverse_path(_tour, a,  b1, b2);    // a [b2..b1] [c1..c2] d
+        reverse_path(_tour, b1, c1, c2);    // a [b2..b1] [c2..c1] d
+        reverse_path(_tour, a,  b2, c1);    // a [c1..c2] [b1..b2] d
+
+        for (auto c : { a, b1, b2, c1, c2, d }) _queue.push(c);
+        return delta;
+    }
+
+    LinKernighanKernel<problem_data_t, UndoableTour<tour_type> > _lin_kernighan;
+    OrOptKernel<problem_data_t, UndoableTour<tour_type> >        _or_opt;
+    UndoableTour<tour_type>                                      _tour;
+    ActiveQueue                                                  _queue;
+};
+
+}
+}
+}
+}
+
+#endif // TSP_LIN_KERNIGHAN_HPP
@@ -0,0 +1,113 @@
+#ifndef TSP_MOVE_OPERATOR_HPP
+#define TSP_MOVE_OPERATOR_HPP
+
+#include "array.hpp"
+#include "moves.hpp"
+#include "onion/MoveOperator.hpp"
+#include <algorithm>
+
+namespace onion{
+namespace cops {
+namespace tsp {
+namespace array {
+
+// In-place implementations of the moves in moves.hpp.
+// No copy of the path is made: apply() touches only the positions changed by the move
+// and returns the parameter of the inverse move as undo token.
+//
+// path_type : path_t<num_cities>, tour_t<index_t> or any container with the same layout (see array.hpp)
+
+template< typename path_type >
+class TwoOptMove : public onion::MoveOperator< path_type, two_opt_t >
+{
+public:
+
+    TwoOptMove():
+        ComponentID( IDBuilder()
+                    .name("TwoOptMove")
+                    .description("Reverses a sub-path in place.")
+                    .type("Move Operator")
+                    .version("v0.1.0")
+                    .problem("TSP")){
+    }
+
+    virtual two_opt_t apply(path_type& p, const two_opt_t& m){
+        return move(p, m);
+    }
+
+    virtual void undo(path_type& p, const two_opt_t& u){
+        move(p, u);
+    }
+
+    // a reversal is its own inverse
+    static inline two_opt_t move(path_type& p, const two_opt_t& m){
+        std::reverse( p.begin() + m.i + 1, p.begin() + m.j + 1 );
+        return m;
+    }
+};
+
+template< typename path_type >
+class SwapMove : public onion::MoveOperator< path_type, swap_t >
+{
+public:
+
+    SwapMove():
+        ComponentID( IDBuilder()
+                    .name("SwapMove")
+                    .description("Swaps two cities in place.")
+                    .type("Move Operator")
+                    .version("v0.1.0")
+                    .problem("TSP")){
+    }
+
+    virtual swap_t apply(path_type& p, const swap_t& m){
+        return move(p, m);
+    }
+
+    virtual void undo(path_type& p, const swap_t& u){
+        move(p, u);
+    }
+
+    // a swap is its own inverse
+    static inline swap_t move(path_type& p, const swap_t& m){
+        std::swap( p[m.i], p[m.j] );
+        return m;
+    }
+};
+
+template< typename path_type >
+class InsertionMove : public onion::MoveOperator< path_type, insertion_t >
+{
+public:
+
+    InsertionMove():
+        ComponentID( IDBuilder()
+                    .name("InsertionMove")
+                    .description("Moves a city to another position in place.")
+                    .type("Move Operator")
+                    .version("v0.1.0")
+                    .problem("TSP")){
+    }
+
+    virtual insertion_t apply(path_type& p, const insertion_t& m){
+        return move(p, m);
+    }
+
+    virtual void undo(path_type& p, const insertion_t& u){
+        move(p, u);
+    }
+
+    // the inverse of moving a city from 'from' to 'to' is moving it back from 'to' to 'from'
+    static inline insertion_t move(path_type& p, const insertion_t& m){
+        if ( m.to > m.from ) std::rotate( p.begin() + m.from, p.begin() + m.from + 1, p.begin() + m.to + 1 );
+        else                 std::rotate( p.begin() + m.to,   p.begin() + m.from,     p.begin() + m.from + 1 );
+        return insertion_t{ m.to, m.from };
+    }
+};
+
+}
+}
+}
+}
+
+#endif // TSP_MOVE_OPERATOR_HPP
@@ -0,0 +1,41 @@
+#ifndef TSP_MOVES_HPP
+#define TSP_MOVES_HPP
+
+namespace onion{
+namespace cops {
+namespace tsp {
+namespace array {
+
+// Transformation parameters for paths (see array.hpp).
+// A path p has num_cities + 1 positions and p[0] == p[num_cities] == 0.
+// Positions 0 and num_cities are never moved, so every transformation keeps the path closed at city 0.
+
+// 2-opt: reverses the sub-path p[i+1..j].
+// Removes edges (p[i],p[i+1]) and (p[j],p[j+1]); adds edges (p[i],p[j]) and (p[i+1],p[j+1]).
+// Valid if 0 <= i, i + 2 <= j and j + 1 <= num_cities.
+struct two_opt_t{
+    unsigned int i;
+    unsigned int j;
+};
+
+// Swap: exchanges the cities at positions i and j.
+// Valid if 1 <= i < j <= num_cities - 1.
+struct swap_t{
+    unsigned int i;
+    unsigned int j;
+};
+
+// Insertion: removes the city at position from and reinserts it so that it ends at position to.
+// The cities between both positions shift by one.
+// Valid if 1 <= from, to <= num_cities - 1 and from != to.
+struct insertion_t{
+    unsigned int from;
+    unsigned int to;
+};
+
+}
+}
+}
+}
+
+#endif // TSP_MOVES_HPP
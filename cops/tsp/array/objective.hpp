@@ -0,0 +1,54 @@
+#ifndef TSP_OBJECTIVE_HPP
+#define TSP_OBJECTIVE_HPP
+
+#include "array.hpp"
+#include "../distance.hpp"
+#include "onion/ObjectiveFunction.hpp"
+
+namespace onion{
+namespace cops {
+namespace tsp {
+namespace array {
+
+// Length of the hamiltonian cycle held by a path: sum of distance(p[k],p[k+1]), k = 0 .. num_cities - 1.
+//
+// problem_data_t : distance data, see ../distance.hpp
+// path_type      : path_t<num_cities>, tour_t<index_t> or any container with the same layout (see array.hpp)
+
+template< typename problem_data_t, typename path_type >
+class TourLength : public onion::ObjectiveFunction< path_type, cost_t<problem_data_t> >
+{
+public:
+
+    TourLength(const problem_data_t& data):
+        ComponentID( IDBuilder()
+                    .name("TourLength")
+                    .description("Length of a hamiltonian cycle.")
+                    .type("Objective Function")
+                    .version("v0.1.0")
+                    .problem("TSP")),
+        _data(data){
+    }
+
+    virtual cost_t<problem_data_t> operator()(const path_type& p){
+        return length(_data, p);
+    }
+
+    static inline cost_t<problem_data_t> length(const problem_data_t& data, const path_type& p){
+        cost_t<problem_data_t> len = 0;
+        const auto n = p.size() - 1;
+        for (decltype(p.size()) k = 0; k < n; ++k) len += distance(data, p[k], p[k+1]);
+        return len;
+    }
+
+private:
+
+    const problem_data_t& _data;
+};
+
+}
+}
+}
+}
+
+#endif // TSP_OBJECTIVE_HPP
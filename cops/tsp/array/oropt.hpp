@@ -0,0 +1,236 @@
+#ifndef TSP_OROPT_HPP
+#define TSP_OROPT_HPP
+
+#include "array.hpp"
+#include "array_tour.hpp"
+#include "two_level_tour.hpp"
+#include "improvement.hpp"
+#include "2opt.hpp"
+#include "../candidates.hpp"
+#include "../distance.hpp"
+#include "onion/PerturbationOperator.hpp"
+
+namespace onion{
+namespace cops {
+namespace tsp {
+namespace array {
+
+// Or-opt kernel: searches the Or-opt moves that involve city a.
+//
+// An Or-opt move relocates a segment of 1 to max_length (3) consecutive cities to another place of the tour,
+// optionally reversed. With the segment s1..s2 (forward), p = prev(s1) and n = next(s2), it
+// removes (p,s1), (s2,n), (c,d) and adds (p,n), (c,e), (d,f), where (c,d) is a tour edge outside the segment,
+// e is the end of the segment placed next to c and f is the other end.
+//
+// a is always one end of the segment (e = a) and c runs over the candidates of a, nearest first.
+// The search stops when d(a,c) is not shorter than the gain of removing the segment,
+// d(p,s1) + d(s2,n) - d(p,n). The variation of the tour length is computed in O(1) with 6 distance reads.
+//
+// Moves are applied with two or three reversals (see reverse_path), so they work on any tour type that
+// provides next, prev and reverse.
+
+template< typename problem_data_t, typename tour_type = ArrayTour >
+class OrOptKernel{
+public:
+
+    using cost_type = cost_t<problem_data_t>;
+
+    static constexpr unsigned int max_length = 3;
+
+    OrOptKernel(const problem_data_t& data, const CandidateList& candidates, improvement_t mode):
+        _data(data),
+        _candidates(candidates),
+        _mode(mode){
+    }
+
+    // Applies the first (or best) improving move that involves a and activates the cities it touches.
+    // Returns the variation of the tour length, 0 if no improving move was found.
+    cost_type improve(tour_type& tour, ActiveQueue& queue, unsigned int a){
+        if ( tour.size() < 2 * max_length + 2 ) return 0;
+
+        move_t best;
+        cost_type best_delta = 0;
+
+        for (unsigned int length = 1; length <= max_length; ++length){
+            // a as the first (s1) and as the last (s2) city of the segment; both are the same segment when length is 1
+            for (int end = 0; end < ( length == 1 ? 1 : 2 ); ++end){
+                move_t m;
+                m.s1 = m.s2 = a;
+                for (unsigned int k = 1; k < length; ++k){
+                    if ( end == 0 ) m.s2 = tour.next(m.s2);
+                    else            m.s1 = tour.prev(m.s1);
+                }
+                m.p = tour.prev(m.s1);
+                m.n = tour.next(m.s2);
+                const unsigned int f = ( end == 0 ) ? m.s2 : m.s1;
+
+                const cost_type removed = cost_type( distance(_data, m.p, m.s1) ) + distance(_data, m.s2, m.n)
+                                        - distance(_data, m.p, m.n);
+
+                for (auto it = _candidates.begin(a); it != _candidates.end(a); ++it){
+                    const unsigned int c    = *it;
+                    const cost_type    d_ac = distance(_data, a, c);
+                    if ( d_ac >= removed ) break;
+                    if ( in_segment(tour, m, c) ) continue;
+
+                    for (int side = 0; side < 2; ++side){
+                        const unsigned int d = ( side == 0 ) ? tour.next(c) : tour.prev(c);
+                        if ( in_segment(tour, m, d) ) continue;
+
+                        const cost_type delta = d_ac + distance(_data, d, f) - distance(_data, c, d) - removed;
+                        if ( delta < best_delta ){
+                            best_delta = delta;
+                            best       = m;
+                            // the insertion edge, as (x, next(x))
+                            best.x     = ( side == 0 ) ? c : d;
+                            best.y     = ( side == 0 ) ? d : c;
+                            // the segment keeps its orientation if s1 is placed next to x
+                            best.keep  = ( ( a == m.s1 ) == ( c == best.x ) );
+                            if ( _mode == improvement_t::first ) return apply(tour, queue, best, best_delta);
+                        }
+                    }
+                }
+            }
+        }
+        if ( best_delta >= 0 ) return 0;
+        return apply(tour, queue, best, best_delta);
+    }
+
+private:
+
+    struct move_t{
+        unsigned int s1 = 0, s2 = 0, p = 0, n = 0, x = 0, y = 0;
+        bool         keep = true;
+    };
+
+    static inline bool in_segment(const tour_type& tour, const move_t& m, unsigned int c){
+        return tour.between(m.s1, c, m.s2);
+    }
+
+    // Forward order before the move: p [s1..s2] [n..x] [y..p).
+    // Keeping the orientation is a swap of two adjacent blocks (three reversals),
+    // reversing the segment takes two.
+    static inline cost_type apply(tour_type& tour, ActiveQueue& queue, const move_t& m, cost_type delta){
+        if ( m.keep ){
+            reverse_path(tour, m.p,  m.s1, m.s2);   // p [s2..s1] [n..x] y
+            reverse_path(tour, m.s1, m.n,  m.x);    // p [s2..s1] [x..n] y
+            reverse_path(tour, m.p,  m.s2, m.n);    // p [n..x] [s1..s2] y
+        }
+        else{
+            reverse_path(tour, m.p,  m.s1, m.x);    // p [x..n] [s2..s1] y
+            reverse_path(tour, m.p,  m.x,  m.n);    // p [n..x] [s2..s1] y
+        }
+        queue.push(m.p);
+        queue.push(m.n);
+        queue.push(m.s1);
+        queue.push(m.s2);
+        queue.push(m.x);
+        queue.push(m.y);
+        return delta;
+    }
+
+    const problem_data_t& _data;
+    const CandidateList&  _candidates;
+    improvement_t         _mode;
+};
+
+// Or-opt local search: relocates segments of 1 to 3 cities, optionally reversed,
+// until no improving move is left among the candidate edges.
+// Same machinery as TwoOpt: O(1) deltas, candidate lists and don't-look bits.
+//
+// problem_data_t : distance data, see ../distance.hpp
+// path_type      : path_t<num_cities>, tour_t<index_t> or any container with the same layout (see array.hpp)
+// tour_type      : working tour, ArrayTour or TwoLevelTour (see two_level_tour.hpp)
+
+template< typename problem_data_t, typename path_type, typename tour_type = ArrayTour >
+class OrOpt : public onion::PerturbationOperator< path_type, path_type >
+{
+public:
+
+    using cost_type = cost_t<problem_data_t>;
+
+    OrOpt(const problem_data_t& data, const CandidateList& candidates, improvement_t mode = improvement_t::first):
+        ComponentID( IDBuilder()
+                    .name("OrOpt")
+                    .description("Or-opt local search with neighbour lists and don't-look bits.")
+                    .type("Perturbation Operator")
+                    .version("v0.1.0")
+                    .problem("TSP")),
+        _kernel(data, candidates, mode),
+        _tour(candidates.size()),
+        _queue(candidates.size()){
+    }
+
+    virtual path_type operator()(const path_type& S){
+        path_type result = S;
+        improve(result);
+        return result;
+    }
+
+    cost_type improve(path_type& p){
+        _tour.load(p);
+        _queue.fill();
+        const cost_type delta = run_kernels<cost_type>(_tour, _queue, _kernel);
+        _tour.store(p);
+        return delta;
+    }
+
+private:
+
+    OrOptKernel<problem_data_t, tour_type> _kernel;
+    tour_type                              _tour;
+    ActiveQueue                            _queue;
+};
+
+// 2-opt and Or-opt moves interleaved in a single pass: for each active city, 2-opt moves are tried first
+// and Or-opt moves only if no improving 2-opt move starts at that city.
+// The result is a local optimum with respect to both neighbourhoods.
+
+template< typename problem_data_t, typename path_type, typename tour_type = ArrayTour >
+class TwoOptOrOpt : public onion::PerturbationOperator< path_type, path_type >
+{
+public:
+
+    using cost_type = cost_t<problem_data_t>;
+
+    TwoOptOrOpt(const problem_data_t& data, const CandidateList& candidates, improvement_t mode = improvement_t::first):
+        ComponentID( IDBuilder()
+                    .name("TwoOptOrOpt")
+                    .description("Interleaved 2-opt and Or-opt local search with neighbour lists and don't-look bits.")
+                    .type("Perturbation Operator")
+                    .version("v0.1.0")
+                    .problem("TSP")),
+        _two_opt(data, candidates, mode),
+        _or_opt(data, candidates, mode),
+        _tour(candidates.size()),
+        _queue(candidates.size()){
+    }
+
+    virtual path_type operator()(const path_type& S){
+        path_type result = S;
+        improve(result);
+        return result;
+    }
+
+    cost_type improve(path_type& p){
+        _tour.load(p);
+        _queue.fill();
+        const cost_type delta = run_kernels<cost_type>(_tour, _queue, _two_opt, _or_opt);
+        _tour.store(p);
+        return delta;
+    }
+
+private:
+
+    TwoOptKernel<problem_data_t, tour_type> _two_opt;
+    OrOptKernel<problem_data_t, tour_type>  _or_opt;
+    tour_type                               _tour;
+    ActiveQueue                             _queue;
+};
+
+}
+}
+}
+}
+
+#endif // TSP_OROPT_HPP
@@ -0,0 +1,133 @@
+#ifndef TSP_PARAMETER_OPERATOR_HPP
+#define TSP_PARAMETER_OPERATOR_HPP
+
+#include "moves.hpp"
+#include "onion/ParameterOperator.hpp"
+#include "onion/Random.hpp"
+#include <utility>
+
+namespace onion{
+namespace cops {
+namespace tsp {
+namespace array {
+
+// Random parameters for the moves in moves.hpp. They only depend on the number of cities, so they are valid
+// for every path of that size. num_cities >= 3: a path has at least two cities that can move.
+//
+// RandomTwoOpt    : i uniform in [0, num_cities - 3], then j uniform in [i + 2, num_cities - 1]
+// RandomSwap      : two distinct positions, uniform among the pairs
+// RandomInsertion : two distinct positions, from and to, uniform among the ordered pairs
+//
+// path_type : path_t<num_cities>, tour_t<index_t> or any container with the same layout (see array.hpp)
+// engine_t  : the engine given to the constructor, if any. The parameters are drawn from it, or from
+//             onion::Random() without one. Random() is a virtual call per draw: with a final engine_t
+//             (RandomXoshiro256) and an engine, the draws are direct calls the compiler can inline.
+//             The engine must then be used by a single thread.
+
+template< typename path_type, typename engine_t = onion::RandomEngine >
+class RandomTwoOpt : public onion::ParameterOperator< path_type, two_opt_t >
+{
+public:
+
+    explicit RandomTwoOpt(unsigned int num_cities, engine_t* engine = nullptr):
+        ComponentID( IDBuilder()
+                    .name("RandomTwoOpt")
+                    .description("Draws a random 2-opt move.")
+                    .type("Parameter Operator")
+                    .version("v0.1.0")
+                    .problem("TSP")),
+        _num_cities(num_cities),
+        _engine(engine){
+    }
+
+    virtual two_opt_t operator()(){
+        return _engine ? draw(*_engine) : draw( onion::Random() );
+    }
+
+    template< typename rng_t >
+    two_opt_t draw(rng_t& rng) const noexcept {
+        const unsigned int i = rng.uniform_int_between(0, _num_cities - 3);
+        return two_opt_t{ i, rng.uniform_int_between(i + 2, _num_cities - 1) };
+    }
+
+private:
+
+    unsigned int _num_cities;
+    engine_t*    _engine;
+};
+
+template< typename path_type, typename engine_t = onion::RandomEngine >
+class RandomSwap : public onion::ParameterOperator< path_type, swap_t >
+{
+public:
+
+    explicit RandomSwap(unsigned int num_cities, engine_t* engine = nullptr):
+        ComponentID( IDBuilder()
+                    .name("RandomSwap")
+                    .description("Draws a random swap of two cities.")
+                    .type("Parameter Operator")
+                    .version("v0.1.0")
+                    .problem("TSP")),
+        _num_cities(num_cities),
+        _engine(engine){
+    }
+
+    virtual swap_t operator()(){
+        return _engine ? draw(*_engine) : draw( onion::Random() );
+    }
+
+    template< typename rng_t >
+    swap_t draw(rng_t& rng) const noexcept {
+        unsigned int i = rng.uniform_int_between(1, _num_cities - 1);
+        unsigned int j = rng.uniform_int_between(1, _num_cities - 2);
+        if ( j >= i ) ++j;
+        if ( i > j ) std::swap(i, j);
+        return swap_t{ i, j };
+    }
+
+private:
+
+    unsigned int _num_cities;
+    engine_t*    _engine;
+};
+
+template< typename path_type, typename engine_t = onion::RandomEngine >
+class RandomInsertion : public onion::ParameterOperator< path_type, insertion_t >
+{
+public:
+
+    explicit RandomInsertion(unsigned int num_cities, engine_t* engine = nullptr):
+        ComponentID( IDBuilder()
+                    .name("RandomInsertion")
+                    .description("Draws a random reinsertion of a city.")
+                    .type("Parameter Operator")
+                    .version("v0.1.0")
+                    .problem("TSP")),
+        _num_cities(num_cities),
+        _engine(engine){
+    }
+
+    virtual insertion_t operator()(){
+        return _engine ? draw(*_engine) : draw( onion::Random() );
+    }
+
+    template< typename rng_t >
+    insertion_t draw(rng_t& rng) const noexcept {
+        const unsigned int from = rng.uniform_int_between(1, _num_cities - 1);
+        unsigned int       to   = rng.uniform_int_between(1, _num_cities - 2);
+        if ( to >= from ) ++to;
+        return insertion_t{ from, to };
+    }
+
+private:
+
+    unsigned int _num_cities;
+    engine_t*    _engine;
+};
+
+}
+}
+}
+}
+
+#endif // TSP_PARAMETER_OPERATOR_HPP
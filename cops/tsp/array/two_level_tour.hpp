@@ -0,0 +1,346 @@
+#ifndef TSP_TWO_LEVEL_TOUR_HPP
+#define TSP_TWO_LEVEL_TOUR_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace tsp {
+namespace array {
+
+// Two-level doubly-linked list: working representation of a tour with O(sqrt(n)) reversals
+// (Fredman, Johnson, McGeoch and Ostheimer, "Data structures for traveling salesmen"; used by LKH and Concorde).
+//
+// Same interface as ArrayTour (load, store, next, prev, between, reverse), so the improvement engines take
+// either one as their tour_type. reverse(a,b) is the flip of the papers above.
+//
+// The cities are split into segments of about sqrt(n)/4 consecutive cities (the size that ran fastest with
+// 1e5 to 1e6 cities). Within a segment, cities form a
+// doubly-linked list and carry consecutive sequence numbers; each segment has a reversed bit that tells
+// whether the tour runs through it along or against its list. The segments themselves are kept in tour
+// order in an array, each one knowing its rank in that array.
+//
+// - next, prev    : O(1), a few more reads than ArrayTour
+// - between       : O(1), compares (rank of the segment, oriented sequence number)
+// - reverse       : a path inside a segment is relinked city by city, O(sqrt(n)). A longer path is first
+//                   made to start and end at segment boundaries, by splitting at most two segments, then
+//                   the run of segments is reversed in the array and their bits flipped, O(sqrt(n)).
+//                   A split moves the shorter part of a segment to its neighbour, so the number of segments
+//                   stays the same. When the neighbour would grow too large the part becomes a new segment;
+//                   once there are twice as many segments as at the start, the tour is cut again into even
+//                   segments, O(n), which seldom happens.
+//
+// Like ArrayTour, reverse() may reverse the rest of the tour instead of the path: engines read next() and
+// prev() again after each reversal. ArrayTour is faster up to a few tens of thousands of cities; above,
+// the O(n) reversals of the array dominate the local searches and this tour pays off.
+
+class TwoLevelTour{
+public:
+
+    TwoLevelTour() = default;
+
+    explicit TwoLevelTour(unsigned int num_cities):
+        _parent(num_cities),
+        _seq(num_cities),
+        _next(num_cities),
+        _prev(num_cities),
+        _group( std::max( 8u, static_cast<unsigned int>( std::sqrt( double(num_cities) ) / 4 ) ) ){
+        std::vector<unsigned int> order(num_cities);
+        for (unsigned int k = 0; k < num_cities; ++k) order[k] = k;
+        build(order);
+    }
+
+    unsigned int size() const noexcept { return static_cast<unsigned int>( _parent.size() ); }
+
+    // Loads the first num_cities positions of a path (or of any sequence of cities).
+    template< typename path_type >
+    void load(const path_type& p){
+        _order.resize( size() );
+        for (unsigned int k = 0; k < size(); ++k) _order[k] = p[k];
+        build(_order);
+    }
+
+    // Stores the tour in a path that starts and ends at city 0.
+    template< typename path_type >
+    void store(path_type& p) const {
+        const unsigned int n = size();
+        unsigned int c = 0;
+        for (unsigned int k = 0; k < n; ++k){
+            p[k] = c;
+            c    = next(c);
+        }
+        p[n] = 0;
+    }
+
+    unsigned int next(unsigned int c) const noexcept {
+        const segment_t& s = _segments[ _parent[c] ];
+        if ( c == tail(s) ) return head( _segments[ _order_of_segments[ s.rank + 1 == _num_segments ? 0 : s.rank + 1 ] ] );
+        return s.reversed ? _prev[c] : _next[c];
+    }
+
+    unsigned int prev(unsigned int c) const noexcept {
+        const segment_t& s = _segments[ _parent[c] ];
+        if ( c == head(s) ) return tail( _segments[ _order_of_segments[ s.rank == 0 ? _num_segments - 1 : s.rank - 1 ] ] );
+        return s.reversed ? _next[c] : _prev[c];
+    }
+
+    bool between(unsigned int a, unsigned int b, unsigned int c) const noexcept {
+        const key_t ka = key(a), kb = key(b), kc = key(c);
+        if ( ka <= kc ) return ka <= kb && kb <= kc;
+        return kb >= ka || kb <= kc;
+    }
+
+    void reverse(unsigned int a, unsigned int b){
+        const unsigned int sa = _parent[a], sb = _parent[b];
+        if ( sa == sb ){
+            const int fa = oriented_seq(a), fb = oriented_seq(b);
+            if ( fa <= fb ){
+                reverse_inside(a, b);
+                return;
+            }
+            // a..b leaves the segment and comes back: the rest of the tour, b+1 .. a-1, lies inside it
+            if ( next(b) != a ) reverse_inside( next(b), prev(a) );
+            return;
+        }
+
+        split_before(a, none);
+        if ( _parent[a] == _parent[b] ){
+            // a joined the segment of b, as its first city
+            reverse_inside(a, b);
+            return;
+        }
+        split_before( next(b), _parent[a] );
+        reverse_segments( _segments[ _parent[a] ].rank, _segments[ _parent[b] ].rank );
+        if ( _num_segments > 2 * _initial_segments ) rebalance();
+    }
+
+private:
+
+    struct segment_t{
+        unsigned int first, last;   // ends of the list (smallest and largest sequence number)
+        unsigned int rank;          // position in _order_of_segments
+        bool         reversed;
+    };
+
+    using key_t = std::pair<unsigned int, int>;
+
+    enum : unsigned int { none = ~0u };
+    enum : int { max_seq = 1 << 30 };
+
+    static unsigned int head(const segment_t& s) noexcept { return s.reversed ? s.last : s.first; }
+    static unsigned int tail(const segment_t& s) noexcept { return s.reversed ? s.first : s.last; }
+
+    int oriented_seq(unsigned int c) const noexcept {
+        return _segments[ _parent[c] ].reversed ? -_seq[c] : _seq[c];
+    }
+
+    key_t key(unsigned int c) const noexcept {
+        return key_t( _segments[ _parent[c] ].rank, oriented_seq(c) );
+    }
+
+    // cuts order (the cities in tour order) into segments of _group cities
+    void build(const std::vector<unsigned int>& order){
+        const unsigned int n = static_cast<unsigned int>( order.size() );
+        _num_segments = n ? ( n + _group - 1 ) / _group : 0;
+        _initial_segments = _num_segments;
+        _segments.assign( _num_segments, segment_t{ 0, 0, 0, false } );
+        _order_of_segments.resize(_num_segments);
+        for (unsigned int s = 0; s < _num_segments; ++s){
+            const unsigned int first = s * _group, last = std::min(first + _group, n) - 1;
+            _segments[s] = segment_t{ order[first], order[last], s, false };
+            _order_of_segments[s] = s;
+            for (unsigned int k = first; k <= last; ++k){
+                const unsigned int c = order[k];
+                _parent[c] = s;
+                _seq[c]    = static_cast<int>( k - first );
+                _next[c]   = order[ k + 1 == n ? 0 : k + 1 ];
+                _prev[c]   = order[ k == 0 ? n - 1 : k - 1 ];
+            }
+        }
+    }
+
+    void rebalance(){
+        _order.resize( size() );
+        unsigned int c = 0;
+        for (unsigned int k = 0; k < size(); ++k){
+            _order[k] = c;
+            c = next(c);
+        }
+        build(_order);
+    }
+
+    // reverses the path a..b (forward), which lies inside a segment
+    void reverse_inside(unsigned int a, unsigned int b){
+        segment_t& s = _segments[ _parent[a] ];
+        // x..y is the path in list order
+        const unsigned int x = s.reversed ? b : a, y = s.reversed ? a : b;
+        if ( x == y ) return;
+        const bool         x_first = ( x == s.first ), y_last = ( y == s.last );
+        const unsigned int before = _prev[x], after = _next[y];
+        const int          seq = _seq[x];
+
+        _order.clear();
+        for (unsigned int c = x; ; c = _next[c]){
+            _order.push_back(c);
+            if ( c == y ) break;
+        }
+        // relinks the cities in the opposite order: y .. x
+        const unsigned int m = static_cast<unsigned int>( _order.size() );
+        for (unsigned int k = 0; k < m; ++k){
+            const unsigned int c = _order[m - 1 - k];
+            _seq[c]  = seq + static_cast<int>(k);
+            _prev[c] = ( k == 0 )     ? before : _order[m - k];
+            _next[c] = ( k + 1 == m ) ? after  : _order[m - 2 - k];
+        }
+        if ( x_first ) s.first = y;
+        else           _next[before] = y;
+        if ( y_last )  s.last = x;
+        else           _prev[after] = x;
+    }
+
+    unsigned int segment_size(const segment_t& s) const noexcept {
+        return static_cast<unsigned int>( _seq[s.last] - _seq[s.first] ) + 1;
+    }
+
+    // Makes c the first city (in tour order) of its segment. The shorter of the two parts, before c or from
+    // c on, joins the neighbouring segment on its side, unless that one would grow beyond twice the initial
+    // size or is the segment keep: the part then becomes a new segment.
+    void split_before(unsigned int c, unsigned int keep){
+        const unsigned int id = _parent[c];
+        const segment_t    s  = _segments[id];
+        if ( c == head(s) ) return;
+
+        // in list order, the segment is first .. p, q .. last, and the tour goes from the p side to the q side
+        const unsigned int p = s.reversed ? c : _prev[c];
+        const unsigned int q = s.reversed ? _next[c] : c;
+        const unsigned int low = static_cast<unsigned int>( _seq[p] - _seq[s.first] ) + 1;
+        const unsigned int high = segment_size(s) - low;
+        const bool move_low = low < high;
+        const bool move_before = ( move_low != s.reversed );   // the moved part comes before c in the tour
+
+        // the moved part, in tour order
+        _order.clear();
+        if ( move_before ) for (unsigned int x = head(s); x != c; x = s.reversed ? _prev[x] : _next[x]) _order.push_back(x);
+        else               for (unsigned int x = c; ; x = s.reversed ? _prev[x] : _next[x]){
+                               _order.push_back(x);
+                               if ( x == tail(s) ) break;
+                           }
+        segment_t& kept = _segments[id];
+        if ( move_low ) kept.first = q;
+        else            kept.last  = p;
+
+        const unsigned int r = move_before ? ( s.rank == 0 ? _num_segments - 1 : s.rank - 1 )
+                                           : ( s.rank + 1 == _num_segments ? 0 : s.rank + 1 );
+        const unsigned int neighbour = _order_of_segments[r];
+        if ( neighbour != id && neighbour != keep &&
+             segment_size(_segments[neighbour]) + _order.size() <= 2 * _group ){
+            if ( move_before ) append(neighbour);
+            else               prepend(neighbour);
+            return;
+        }
+
+        const unsigned int new_id = static_cast<unsigned int>( _segments.size() );
+        _segments.push_back( segment_t{ _order.front(), _order.front(), 0, false } );
+        _parent[ _order.front() ] = new_id;
+        _seq[ _order.front() ]    = 0;
+        append(new_id, 1);
+        const unsigned int rank = move_before ? s.rank : s.rank + 1;
+        _order_of_segments.insert( _order_of_segments.begin() + rank, new_id );
+        ++_num_segments;
+        for (unsigned int k = rank; k < _num_segments; ++k) _segments[ _order_of_segments[k] ].rank = k;
+    }
+
+    // the cities _order[from ..] (in tour order) join segment id at its tail, or at its head
+    void append(unsigned int id, std::size_t from = 0){
+        segment_t& t = _segments[id];
+        unsigned int end = tail(t);
+        int seq = _seq[end];
+        for (std::size_t k = from; k < _order.size(); ++k){
+            const unsigned int x = _order[k];
+            seq += t.reversed ? -1 : 1;
+            link(t.reversed ? x : end, t.reversed ? end : x);
+            _seq[x]    = seq;
+            _parent[x] = id;
+            end = x;
+        }
+        if ( t.reversed ) t.first = end;
+        else              t.last  = end;
+        if ( seq < -max_seq || seq > max_seq ) renumber(id);
+    }
+
+    void prepend(unsigned int id){
+        segment_t& t = _segments[id];
+        unsigned int end = head(t);
+        int seq = _seq[end];
+        for (std::size_t k = _order.size(); k-- > 0; ){
+            const unsigned int x = _order[k];
+            seq += t.reversed ? 1 : -1;
+            link(t.reversed ? end : x, t.reversed ? x : end);
+            _seq[x]    = seq;
+            _parent[x] = id;
+            end = x;
+        }
+        if ( t.reversed ) t.last  = end;
+        else              t.first = end;
+        if ( seq < -max_seq || seq > max_seq ) renumber(id);
+    }
+
+    // sequence numbers drift as segments gain cities on one side and lose them on the other
+    void renumber(unsigned int id) noexcept {
+        const segment_t& t = _segments[id];
+        int seq = 0;
+        for (unsigned int x = t.first; ; x = _next[x]){
+            _seq[x] = seq++;
+            if ( x == t.last ) break;
+        }
+    }
+
+    // x before y in list order
+    void link(unsigned int x, unsigned int y) noexcept {
+        _next[x] = y;
+        _prev[y] = x;
+    }
+
+    // reverses the run of segments of ranks i .. j (forward, possibly wrapping), or the rest of the tour
+    void reverse_segments(unsigned int i, unsigned int j){
+        const unsigned int n = _num_segments;
+        unsigned int len = ( j >= i ? j - i : j + n - i ) + 1;
+        if ( 2 * len > n ){
+            const unsigned int old_i = i;
+            i   = ( j + 1 == n ) ? 0 : j + 1;
+            j   = ( old_i == 0 ) ? n - 1 : old_i - 1;
+            len = n - len;
+        }
+        for (unsigned int k = 0; k < len; ++k){
+            _segments[ _order_of_segments[ i + k < n ? i + k : i + k - n ] ].reversed ^= true;
+        }
+        for (unsigned int s = len / 2; s > 0; --s){
+            std::swap( _order_of_segments[i], _order_of_segments[j] );
+            _segments[ _order_of_segments[i] ].rank = i;
+            _segments[ _order_of_segments[j] ].rank = j;
+            if ( ++i == n ) i = 0;
+            j = ( j == 0 ) ? n - 1 : j - 1;
+        }
+    }
+
+    std::vector<unsigned int> _parent;              // segment of each city
+    std::vector<int>          _seq;                 // sequence number of each city in its segment
+    std::vector<unsigned int> _next, _prev;         // list order inside the segments
+    std::vector<segment_t>    _segments;
+    std::vector<unsigned int> _order_of_segments;   // segments in tour order
+    std::vector<unsigned int> _order;               // buffer
+    unsigned int              _group = 8;
+    unsigned int              _num_segments = 0;
+    unsigned int              _initial_segments = 0;
+};
+
+}
+}
+}
+}
+
+#endif // TSP_TWO_LEVEL_TOUR_HPP
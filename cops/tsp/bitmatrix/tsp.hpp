@@ -1 +1,217 @@
-//#ifndef TSP_BITMATRIX_H
+#ifndef TSP_BITMATRIX_HPP
+#define TSP_BITMATRIX_HPP
+
+#include "../distance.hpp"
+#include "../../bits.hpp"
+#include "onion/AlignedAllocator.hpp"
+#include "onion/ObjectiveFunction.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace tsp {
+namespace bitmatrix {
+
+// Tour, or any set of edges, as a symmetric adjacency bit matrix: bit (i,j) and bit (j,i) are set when the
+// edge (i,j) belongs to the set. Row i takes ceil(n/64) words, so a matrix takes n^2/8 bytes (125 KB for
+// 1000 cities, 12.5 MB for 10000): this representation is meant for populations of tours of small and
+// medium instances.
+//
+// Comparisons and combinations of edge sets are word-parallel (see ../../bits.hpp), with no sorting and
+// no hashing of edges:
+//
+// common_edges(a,b)  : number of edges in both sets, popcount(a AND b) / 2
+// bond_distance(a,b) : number of edges in one set only, halved: popcount(a XOR b) / 4. For two tours it is
+//                      the number of edges of a that are not in b, from 0 (same cycle, whatever its
+//                      orientation and first city) to n
+// a & b, a | b       : intersection and union, the edge graphs used by edge recombination crossovers
+//
+// These read the whole matrices, n^2/64 words: about 7 us for two tours of 1000 cities with AVX2, while the
+// matrices stay in the cache. To compare one path with many matrices, common_edges(a,p) reads only the n
+// bits of the edges of p.
+//
+// load() and store() convert from and to the paths of ../array (|p| = n + 1, p[0] = p[n] = 0).
+
+class EdgeMatrix{
+public:
+
+    EdgeMatrix() = default;
+
+    explicit EdgeMatrix(unsigned int num_cities):
+        _size(num_cities),
+        _words( ( std::size_t(num_cities) + 63 ) / 64 ),
+        _bits( std::size_t(num_cities) * _words, 0 ){
+    }
+
+    // the edges of a path
+    template< typename path_type,
+              typename std::enable_if< !std::is_arithmetic<path_type>::value, int >::type = 0 >
+    explicit EdgeMatrix(const path_type& p):
+        EdgeMatrix( static_cast<unsigned int>( p.size() - 1 ) ){
+        load(p);
+    }
+
+    unsigned int size() const noexcept { return _size; }
+
+    // words of a row, and of the whole matrix
+    std::size_t words_per_row() const noexcept { return _words; }
+    std::size_t num_words()     const noexcept { return _bits.size(); }
+
+    const std::uint64_t* data()               const noexcept { return _bits.data(); }
+    const std::uint64_t* row(unsigned int i)  const noexcept { return _bits.data() + i * _words; }
+
+    bool contains(unsigned int i, unsigned int j) const noexcept {
+        return ( _bits[ i * _words + j / 64 ] >> ( j % 64 ) ) & 1;
+    }
+
+    void insert(unsigned int i, unsigned int j) noexcept {
+        _bits[ i * _words + j / 64 ] |= std::uint64_t(1) << ( j % 64 );
+        _bits[ j * _words + i / 64 ] |= std::uint64_t(1) << ( i % 64 );
+    }
+
+    void erase(unsigned int i, unsigned int j) noexcept {
+        _bits[ i * _words + j / 64 ] &= ~( std::uint64_t(1) << ( j % 64 ) );
+        _bits[ j * _words + i / 64 ] &= ~( std::uint64_t(1) << ( i % 64 ) );
+    }
+
+    void clear() noexcept {
+        for (auto& w : _bits) w = 0;
+    }
+
+    unsigned int degree(unsigned int i) const noexcept {
+        return static_cast<unsigned int>( popcount( row(i), _words ) );
+    }
+
+    std::size_t num_edges() const noexcept {
+        return popcount( _bits.data(), _bits.size() ) / 2;
+    }
+
+    // calls f(j) for each neighbour j of city i, in increasing order
+    template< typename function_t >
+    void for_each_neighbour(unsigned int i, function_t f) const {
+        const std::uint64_t* r = row(i);
+        for (std::size_t w = 0; w < _words; ++w){
+            for (std::uint64_t bits = r[w]; bits; bits &= bits - 1){
+                f( static_cast<unsigned int>( w * 64 + lowest_bit(bits) ) );
+            }
+        }
+    }
+
+    // Replaces the set by the edges of a path of the same number of cities.
+    template< typename path_type >
+    void load(const path_type& p){
+        clear();
+        for (unsigned int k = 0; k < _size; ++k) insert( p[k], p[k+1] );
+    }
+
+    // Stores the cycle in a path that starts and ends at city 0. Returns false, leaving p unspecified,
+    // if the set is not a hamiltonian cycle. O(n^2/64): each step scans a row.
+    template< typename path_type >
+    bool store(path_type& p) const {
+        const unsigned int n = _size;
+        if ( n < 3 ){
+            for (unsigned int k = 0; k < n; ++k) p[k] = k;
+            p[n] = 0;
+            return num_edges() == ( n == 2 ? 1u : 0u );
+        }
+        unsigned int previous = n, city = 0;
+        for (unsigned int k = 0; k < n; ++k){
+            if ( k > 0 && city == 0 ) return false;     // a shorter cycle through city 0
+            p[k] = city;
+            if ( degree(city) != 2 ) return false;
+            unsigned int next = n;
+            for_each_neighbour(city, [&](unsigned int j){ if ( j != previous && next == n ) next = j; });
+            previous = city;
+            city     = next;
+        }
+        p[n] = 0;
+        return city == 0;
+    }
+
+    EdgeMatrix& operator&=(const EdgeMatrix& other) noexcept {
+        for (std::size_t k = 0; k < _bits.size(); ++k) _bits[k] &= other._bits[k];
+        return *this;
+    }
+
+    EdgeMatrix& operator|=(const EdgeMatrix& other) noexcept {
+        for (std::size_t k = 0; k < _bits.size(); ++k) _bits[k] |= other._bits[k];
+        return *this;
+    }
+
+    friend EdgeMatrix operator&(EdgeMatrix a, const EdgeMatrix& b){ return a &= b; }
+    friend EdgeMatrix operator|(EdgeMatrix a, const EdgeMatrix& b){ return a |= b; }
+
+    bool operator==(const EdgeMatrix& other) const noexcept { return _size == other._size && _bits == other._bits; }
+    bool operator!=(const EdgeMatrix& other) const noexcept { return !( *this == other ); }
+
+private:
+
+    unsigned int _size = 0;
+    std::size_t  _words = 0;
+    std::vector< std::uint64_t, onion::AlignedAllocator<std::uint64_t> > _bits;
+};
+
+// number of edges in both sets (both matrices must have the same size)
+inline std::size_t common_edges(const EdgeMatrix& a, const EdgeMatrix& b) noexcept {
+    return popcount_and( a.data(), b.data(), a.num_words() ) / 2;
+}
+
+// number of edges of a path that belong to a set, O(n)
+template< typename path_type,
+          typename std::enable_if< !std::is_same<path_type, EdgeMatrix>::value, int >::type = 0 >
+inline std::size_t common_edges(const EdgeMatrix& a, const path_type& p) noexcept {
+    std::size_t count = 0;
+    for (unsigned int k = 0; k < a.size(); ++k) count += a.contains( p[k], p[k+1] );
+    return count;
+}
+
+// number of edges in one set only, halved: n - common_edges(a,b) for two tours of n cities
+inline std::size_t bond_distance(const EdgeMatrix& a, const EdgeMatrix& b) noexcept {
+    return popcount_xor( a.data(), b.data(), a.num_words() ) / 4;
+}
+
+// Sum of the lengths of the edges of the set (the length of the tour it holds).
+//
+// problem_data_t : distance data, see ../distance.hpp
+
+template< typename problem_data_t >
+class TourLength : public onion::ObjectiveFunction< EdgeMatrix, cost_t<problem_data_t> >
+{
+public:
+
+    TourLength(const problem_data_t& data):
+        ComponentID( IDBuilder()
+                    .name("TourLength")
+                    .description("Length of the edges of a bit matrix tour.")
+                    .type("Objective Function")
+                    .version("v0.1.0")
+                    .problem("TSP")),
+        _data(data){
+    }
+
+    virtual cost_t<problem_data_t> operator()(const EdgeMatrix& m){
+        return length(_data, m);
+    }
+
+    static inline cost_t<problem_data_t> length(const problem_data_t& data, const EdgeMatrix& m){
+        cost_t<problem_data_t> len = 0;
+        for (unsigned int i = 0; i < m.size(); ++i){
+            m.for_each_neighbour(i, [&](unsigned int j){ if ( i < j ) len += distance(data, i, j); });
+        }
+        return len;
+    }
+
+private:
+
+    const problem_data_t& _data;
+};
+
+}
+}
+}
+}
+
+#endif // TSP_BITMATRIX_HPP
@@ -0,0 +1,277 @@
+#ifndef TSP_CANDIDATE_BUILDER_HPP
+#define TSP_CANDIDATE_BUILDER_HPP
+
+#include "candidates.hpp"
+#include "coordinates.hpp"
+#include "distance.hpp"
+#include "kdtree.hpp"
+#include "../parallel.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace tsp {
+
+// Builders of candidate lists (see candidates.hpp) that avoid the O(n^2) brute force of nearest_neighbours():
+//
+// - kd_nearest_neighbours: the k nearest cities of each city, through a k-d tree (see kdtree.hpp).
+// - quadrant_neighbours:   the k/4 nearest cities in each quadrant around a city, completed with its nearest
+//                          cities. On clustered instances the nearest cities of a city all belong to its
+//                          cluster; quadrant neighbours keep edges towards the neighbouring clusters.
+// - alpha_nearest:         the k cities of smallest alpha-nearness (Helsgaun, "An effective implementation
+//                          of the Lin-Kernighan traveling salesman heuristic"), among the candidates of a
+//                          sparser graph (the lists built by the two functions above).
+//
+// The searches of different cities are independent and are shared among num_threads threads (0: one per
+// hardware thread, see ../parallel.hpp). All of them return lists sorted by increasing distance (by
+// increasing alpha-nearness for alpha_nearest), which is what the move operators expect.
+//
+// The k-d tree works on plane coordinates: GEO instances use the brute force search in
+// kd_nearest_neighbours, and their quadrants are taken in the (latitude, longitude) plane.
+
+// k nearest cities of each city, O(n log n).
+inline CandidateList kd_nearest_neighbours(const CoordinateDistance& coordinates, unsigned int k,
+                                           unsigned int num_threads = 1){
+    const unsigned int n = coordinates.size();
+    if ( coordinates.metric() == metric_t::geo ) return nearest_neighbours(coordinates, n, k, num_threads);
+    k = std::min( k, n ? n - 1 : 0 );
+
+    const KdTree tree( coordinates.x(), coordinates.y(), n );
+    std::vector<unsigned int> offsets(n + 1);
+    std::vector<unsigned int> neighbours( std::size_t(n) * k );
+    for (unsigned int i = 0; i <= n; ++i) offsets[i] = i * k;
+
+    parallel_for( n, num_threads, [&](std::size_t first, std::size_t last){
+        std::vector<unsigned int> near;
+        for (unsigned int i = static_cast<unsigned int>(first); i < last; ++i){
+            tree.k_nearest(i, k, near);
+            std::copy( near.begin(), near.end(), neighbours.begin() + std::size_t(i) * k );
+        }
+    } );
+
+    return CandidateList( std::move(offsets), std::move(neighbours) );
+}
+
+namespace detail{
+
+// adds city j to a candidate list, unless it is already there
+inline void add(std::vector< std::pair<double, unsigned int> >& list, double d, unsigned int j){
+    for (const auto& p : list) if ( p.second == j ) return;
+    list.emplace_back(d, j);
+}
+
+}
+
+// k/4 nearest cities in each quadrant around each city, then its nearest cities up to k candidates,
+// sorted by distance. A quadrant with fewer than k/4 cities leaves its share to the nearest cities.
+inline CandidateList quadrant_neighbours(const CoordinateDistance& coordinates, unsigned int k,
+                                         unsigned int num_threads = 1){
+    const unsigned int n = coordinates.size();
+    k = std::min( k, n ? n - 1 : 0 );
+
+    const KdTree tree( coordinates.x(), coordinates.y(), n );
+    std::vector<unsigned int> offsets(n + 1);
+    std::vector<unsigned int> neighbours( std::size_t(n) * k );
+    for (unsigned int i = 0; i <= n; ++i) offsets[i] = i * k;
+
+    const double* x = coordinates.x();
+    const double* y = coordinates.y();
+    const unsigned int share = k / 4;
+
+    parallel_for( n, num_threads, [&](std::size_t first, std::size_t last){
+        std::vector<unsigned int> near, in_quadrant;
+        std::vector< std::pair<double, unsigned int> > list;
+        for (unsigned int i = static_cast<unsigned int>(first); i < last; ++i){
+            list.clear();
+            tree.k_nearest(i, k, near);
+
+            // the nearest cities of a quadrant are usually among the k nearest cities: the tree is searched
+            // again only for the quadrants that have fewer than k/4 of them
+            unsigned int count[4] = { 0, 0, 0, 0 };
+            for (auto j : near){
+                const int q = ( x[j] < x[i] ) | ( ( y[j] < y[i] ) << 1 );
+                if ( count[q]++ < share ) list.emplace_back( tree.distance2(i, j), j );
+            }
+            for (int q = 0; q < 4; ++q){
+                if ( count[q] >= share ) continue;
+                tree.k_nearest(i, share, in_quadrant, q);
+                for (auto j : in_quadrant) detail::add(list, tree.distance2(i, j), j);
+            }
+            for (auto it = near.begin(); it != near.end() && list.size() < k; ++it) detail::add(list, tree.distance2(i, *it), *it);
+            std::sort( list.begin(), list.end() );
+            for (unsigned int r = 0; r < k; ++r) neighbours[ std::size_t(i) * k + r ] = list[r].second;
+        }
+    } );
+
+    return CandidateList( std::move(offsets), std::move(neighbours) );
+}
+
+// Alpha-nearness of the edges of graph, the candidate lists of a sparse graph that contains the good edges
+// (quadrant_neighbours with k = 10 .. 16, for instance), and the k best edges of each city.
+//
+// alpha(i,j) is the increase in length of the minimum 1-tree when it is forced to contain the edge (i,j):
+// 0 for the edges of the 1-tree, and c(i,j) minus the longest edge on the tree path from i to j otherwise.
+// The 1-tree is a minimum spanning tree of the cities other than city 0, plus the two shortest edges of city 0.
+// Edges good by this measure are more likely to belong to an optimal tour than the nearest ones: with the same
+// number of candidates, the local searches find better tours.
+//
+// The spanning tree is computed on the (symmetrized) graph only, with Kruskal's algorithm. Each edge of the
+// tree creates a node of a merge tree, whose children are the two components it joins: the longest edge on
+// the tree path from i to j is the edge of the lowest common ancestor of i and j in the merge tree.
+// These are found for all the graph edges at once (offline, Tarjan), so the whole computation takes
+// O(m log m) for the m edges of the graph. If the graph is not connected (once city 0 is removed), the edges
+// between its components get alpha = 0. The penalties of Held and Karp's subgradient optimization, which
+// LKH adds to the distances, are not applied.
+template< typename problem_data_t >
+CandidateList alpha_nearest(const problem_data_t& data, const CandidateList& graph, unsigned int k,
+                            unsigned int num_threads = 1){
+    using alpha_t = cost_t<problem_data_t>;
+    const unsigned int none = KdTree::none;
+    const unsigned int n = graph.size();
+    const unsigned int special = 0;
+
+    // undirected edges, (i,j) with i < j
+    std::vector< std::pair<unsigned int, unsigned int> > edges;
+    edges.reserve( graph.num_neighbours() );
+    for (unsigned int i = 0; i < n; ++i){
+        for (auto it = graph.begin(i); it != graph.end(i); ++it){
+            if ( *it != i ) edges.emplace_back( std::min(i, *it), std::max(i, *it) );
+        }
+    }
+    std::sort( edges.begin(), edges.end() );
+    edges.erase( std::unique( edges.begin(), edges.end() ), edges.end() );
+    const std::size_t m = edges.size();
+
+    std::vector<alpha_t> weight(m);
+    parallel_for( m, num_threads, [&](std::size_t first, std::size_t last){
+        for (std::size_t e = first; e < last; ++e) weight[e] = distance(data, edges[e].first, edges[e].second);
+    } );
+
+    // adjacency of the symmetrized graph, with the edge ids
+    std::vector<std::size_t>  offsets(n + 1, 0);
+    std::vector<unsigned int> adjacent(2 * m), edge_of(2 * m);
+    for (const auto& e : edges){ ++offsets[e.first + 1];  ++offsets[e.second + 1]; }
+    for (unsigned int i = 0; i < n; ++i) offsets[i + 1] += offsets[i];
+    {
+        std::vector<std::size_t> position( offsets.begin(), offsets.end() - 1 );
+        for (std::size_t e = 0; e < m; ++e){
+            const unsigned int a = edges[e].first, b = edges[e].second;
+            adjacent[ position[a] ] = b;  edge_of[ position[a]++ ] = static_cast<unsigned int>(e);
+            adjacent[ position[b] ] = a;  edge_of[ position[b]++ ] = static_cast<unsigned int>(e);
+        }
+    }
+
+    // union-find over the nodes of the merge tree: cities 0 .. n-1, then one node per tree edge
+    std::vector<unsigned int> root( 2 * std::size_t(n) );
+    std::iota( root.begin(), root.end(), 0u );
+    auto find = [&root](unsigned int v){
+        while ( root[v] != v ){ root[v] = root[ root[v] ];  v = root[v]; }
+        return v;
+    };
+
+    // Kruskal: component representatives are the roots of their merge trees
+    std::vector<unsigned int> parent( 2 * std::size_t(n), none ), left, right;
+    std::vector<alpha_t>      merge_weight;
+    {
+        std::vector<unsigned int> order(m);
+        std::iota( order.begin(), order.end(), 0u );
+        std::sort( order.begin(), order.end(), [&weight](unsigned int a, unsigned int b){
+            return weight[a] < weight[b] || ( weight[a] == weight[b] && a < b );
+        } );
+        for (auto e : order){
+            const unsigned int a = edges[e].first, b = edges[e].second;
+            if ( a == special ) continue;
+            const unsigned int ra = find(a), rb = find(b);
+            if ( ra == rb ) continue;
+            const unsigned int node = n + static_cast<unsigned int>( left.size() );
+            left.push_back(ra);
+            right.push_back(rb);
+            merge_weight.push_back( weight[e] );
+            root[ra] = root[rb] = node;
+            parent[ra] = parent[rb] = node;
+        }
+    }
+
+    // lowest common ancestors of the graph edges in the merge tree (Tarjan), one iterative walk per tree
+    std::vector<unsigned int> lca( m, none ), ancestor( 2 * std::size_t(n) );
+    std::vector<unsigned int> tree_of( n, none );  // the walk that visited each city
+    std::iota( root.begin(), root.end(), 0u );
+    std::iota( ancestor.begin(), ancestor.end(), 0u );
+    std::vector< std::pair<unsigned int, int> > stack;  // node, children done
+    const unsigned int num_nodes = n + static_cast<unsigned int>( left.size() );
+    for (unsigned int top = 0; top < num_nodes; ++top){
+        if ( parent[top] != none || top == special ) continue;
+        stack.emplace_back(top, 0);
+        while ( !stack.empty() ){
+            const unsigned int v = stack.back().first;
+            if ( v < n ){
+                tree_of[v] = top;
+                for (std::size_t p = offsets[v]; p < offsets[v + 1]; ++p){
+                    const unsigned int w = adjacent[p];
+                    if ( tree_of[w] == top ) lca[ edge_of[p] ] = ancestor[ find(w) ];
+                }
+                stack.pop_back();
+            }
+            else if ( stack.back().second < 2 ){
+                const int done = stack.back().second++;
+                if ( done == 1 ){
+                    root[ find( left[v - n] ) ] = v;
+                    ancestor[ find(v) ] = v;
+                }
+                stack.emplace_back( done == 0 ? left[v - n] : right[v - n], 0 );
+            }
+            else{
+                root[ find( right[v - n] ) ] = v;
+                ancestor[ find(v) ] = v;
+                stack.pop_back();
+            }
+        }
+    }
+
+    // city 0: alpha(0,j) = c(0,j) minus its second shortest edge
+    alpha_t first = std::numeric_limits<alpha_t>::max(), second = first;
+    for (std::size_t p = offsets[special]; p < offsets[special + 1]; ++p){
+        const alpha_t w = weight[ edge_of[p] ];
+        if ( w < first ){ second = first;  first = w; }
+        else if ( w < second ) second = w;
+    }
+
+    std::vector<alpha_t> alpha(m, 0);
+    for (std::size_t e = 0; e < m; ++e){
+        if ( edges[e].first == special ) alpha[e] = weight[e] > second ? weight[e] - second : 0;
+        else if ( lca[e] != none )       alpha[e] = weight[e] - merge_weight[ lca[e] - n ];
+    }
+
+    // the k best edges of each city, by alpha then by length
+    std::vector<unsigned int> list_offsets(n + 1, 0);
+    for (unsigned int i = 0; i < n; ++i){
+        list_offsets[i + 1] = list_offsets[i] + static_cast<unsigned int>( std::min<std::size_t>( k, offsets[i + 1] - offsets[i] ) );
+    }
+    std::vector<unsigned int> neighbours( list_offsets[n] );
+    parallel_for( n, num_threads, [&](std::size_t first_city, std::size_t last_city){
+        std::vector< std::pair< std::pair<alpha_t, alpha_t>, unsigned int > > list;
+        for (unsigned int i = static_cast<unsigned int>(first_city); i < last_city; ++i){
+            list.clear();
+            for (std::size_t p = offsets[i]; p < offsets[i + 1]; ++p){
+                const unsigned int e = edge_of[p];
+                list.emplace_back( std::make_pair( alpha[e], weight[e] ), adjacent[p] );
+            }
+            const std::size_t size = list_offsets[i + 1] - list_offsets[i];
+            std::partial_sort( list.begin(), list.begin() + size, list.end() );
+            for (std::size_t r = 0; r < size; ++r) neighbours[ list_offsets[i] + r ] = list[r].second;
+        }
+    } );
+
+    return CandidateList( std::move(list_offsets), std::move(neighbours) );
+}
+
+}
+}
+}
+
+#endif // TSP_CANDIDATE_BUILDER_HPP
@@ -0,0 +1,136 @@
+#ifndef TSP_CANDIDATES_HPP
+#define TSP_CANDIDATES_HPP
+
+#include "distance.hpp"
+#include "../parallel.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace tsp {
+
+// Candidate neighbour lists.
+//
+// Improvement moves (2-opt, Or-opt ...) only look for new edges between a city and its candidates.
+// This turns an O(n^2) neighbourhood into an O(k.n) one, where k is the number of candidates per city.
+//
+// Lists are stored in compressed sparse row (CSR) form: the candidates of all cities are kept in a single
+// array, city c owning the range [offset(c), offset(c+1)). Candidates of a city are sorted by increasing
+// distance, so a move search can stop as soon as the first new edge becomes too long.
+// The list either owns its arrays or is a view of arrays kept elsewhere (see instance_cache.hpp).
+
+class CandidateList{
+public:
+
+    CandidateList() = default;
+
+    CandidateList(std::vector<unsigned int> offsets, std::vector<unsigned int> neighbours):
+        _offsets_storage(std::move(offsets)),
+        _neighbours_storage(std::move(neighbours)){
+        point_to_storage();
+    }
+
+    // view of lists kept elsewhere (a cache file, for instance): num_cities + 1 offsets and
+    // offsets[num_cities] neighbours; they are not copied and must outlive the list
+    CandidateList(unsigned int num_cities, const unsigned int* offsets, const unsigned int* neighbours):
+        _size(num_cities),
+        _offsets(offsets),
+        _neighbours(neighbours){
+    }
+
+    CandidateList(const CandidateList& other):
+        _offsets_storage(other._offsets_storage),
+        _neighbours_storage(other._neighbours_storage){
+        if ( other.owner() ) point_to_storage();
+        else{
+            _size       = other._size;
+            _offsets    = other._offsets;
+            _neighbours = other._neighbours;
+        }
+    }
+
+    CandidateList& operator=(const CandidateList& other){
+        if ( this != &other ){
+            CandidateList copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    // moving a vector keeps its buffer, so the pointers stay valid
+    CandidateList(CandidateList&&) noexcept = default;
+    CandidateList& operator=(CandidateList&&) noexcept = default;
+
+    // number of cities
+    unsigned int size() const noexcept { return _size; }
+
+    // number of candidates of city c
+    unsigned int degree(unsigned int c) const noexcept {
+        return _offsets[c+1] - _offsets[c];
+    }
+
+    const unsigned int* begin(unsigned int c) const noexcept { return _neighbours + _offsets[c]; }
+    const unsigned int* end(unsigned int c)   const noexcept { return _neighbours + _offsets[c+1]; }
+
+    // CSR arrays: size() + 1 offsets and num_neighbours() neighbours
+    const unsigned int* offsets()        const noexcept { return _offsets; }
+    const unsigned int* neighbours()     const noexcept { return _neighbours; }
+    std::size_t         num_neighbours() const noexcept { return _size ? _offsets[_size] : 0; }
+
+    bool owner() const noexcept { return !_offsets_storage.empty(); }
+
+private:
+
+    void point_to_storage() noexcept {
+        _size       = _offsets_storage.empty() ? 0 : static_cast<unsigned int>( _offsets_storage.size() - 1 );
+        _offsets    = _offsets_storage.data();
+        _neighbours = _neighbours_storage.data();
+    }
+
+    std::vector<unsigned int> _offsets_storage;
+    std::vector<unsigned int> _neighbours_storage;
+    unsigned int              _size = 0;
+    const unsigned int*       _offsets = nullptr;
+    const unsigned int*       _neighbours = nullptr;
+};
+
+// Builds the lists of the k nearest cities of each city by brute force: O(n^2) distance reads,
+// one row at a time through the batch distances() call. Rows are shared among num_threads threads
+// (0: one per hardware thread), see ../parallel.hpp.
+template< typename problem_data_t >
+CandidateList nearest_neighbours(const problem_data_t& data, unsigned int num_cities, unsigned int k,
+                                 unsigned int num_threads = 1){
+    k = std::min( k, num_cities ? num_cities - 1 : 0 );
+
+    std::vector<unsigned int> offsets(num_cities + 1);
+    std::vector<unsigned int> neighbours( static_cast<std::size_t>(num_cities) * k );
+    std::vector<unsigned int> cities(num_cities);
+    for (unsigned int j = 0; j < num_cities; ++j) cities[j] = j;
+    for (unsigned int i = 0; i <= num_cities; ++i) offsets[i] = i * k;
+
+    parallel_for( num_cities, num_threads, [&](std::size_t first, std::size_t last){
+        std::vector< std::pair< distance_t<problem_data_t>, unsigned int > > row;
+        std::vector< distance_t<problem_data_t> > dist(num_cities);
+        row.reserve(num_cities);
+        for (unsigned int i = static_cast<unsigned int>(first); i < last; ++i){
+            row.clear();
+            distances(data, i, cities.data(), num_cities, dist.data());
+            for (unsigned int j = 0; j < num_cities; ++j){
+                if ( j != i ) row.emplace_back( dist[j], j );
+            }
+            std::partial_sort( row.begin(), row.begin() + k, row.end() );
+            for (unsigned int r = 0; r < k; ++r) neighbours[ std::size_t(i) * k + r ] = row[r].second;
+        }
+    } );
+
+    return CandidateList( std::move(offsets), std::move(neighbours) );
+}
+
+}
+}
+}
+
+#endif // TSP_CANDIDATES_HPP
@@ -0,0 +1,215 @@
+#ifndef TSP_COORDINATES_HPP
+#define TSP_COORDINATES_HPP
+
+#include "onion/AlignedAllocator.hpp"
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace onion{
+namespace cops {
+namespace tsp {
+
+// TSPLIB distance functions computed from node coordinates (TSPLIB 95, section 2).
+enum class metric_t{
+    euc_2d,     // nint( sqrt(dx^2 + dy^2) )
+    ceil_2d,    // ceil( sqrt(dx^2 + dy^2) )
+    geo,        // great circle distance in km; coordinates are latitude and longitude in DDD.MM format
+    att         // pseudo-Euclidean distance of the att48 and att532 instances
+};
+
+// Distance oracle that computes distances on demand from the coordinates of the cities.
+//
+// Memory is O(n) (two aligned arrays of doubles, structure of arrays) instead of the O(n^2) of a matrix, at the
+// cost of a square root (or a few trigonometric functions for GEO) per distance. For large instances, a
+// computed distance is usually faster than a matrix read that misses the cache.
+//
+// distances(i,js,m,out) computes a batch of distances from city i. With AVX2 (SSE2) 4 (2) EUC_2D or CEIL_2D
+// distances are computed at once; the results are the same as those of operator().
+// GEO and ATT batches are computed one distance at a time. GEO needs cos and acos, which have no SIMD
+// instruction: a vector approximation would differ from std::cos/std::acos in the last bits, and the
+// truncation of TSPLIB turns such a difference into a distance off by one from operator() (and from the
+// published optima). The trigonometry, not the loop, is the cost of a GEO distance anyway.
+// GEO coordinates are converted once, at construction.
+// The oracle either owns its coordinates or is a view of coordinates kept elsewhere (see instance_cache.hpp).
+
+class CoordinateDistance{
+public:
+
+    using value_type    = int;
+    using coordinates_t = std::vector< double, onion::AlignedAllocator<double> >;
+
+    CoordinateDistance() = default;
+
+    CoordinateDistance(metric_t metric, const std::vector<double>& x, const std::vector<double>& y):
+        CoordinateDistance( metric, coordinates_t( x.begin(), x.end() ), coordinates_t( y.begin(), y.end() ) ){
+    }
+
+    // takes the coordinates without copying them
+    CoordinateDistance(metric_t metric, coordinates_t&& x, coordinates_t&& y):
+        _metric(metric),
+        _x_storage( std::move(x) ),
+        _y_storage( std::move(y) ){
+        if ( _metric == metric_t::geo ){
+            for (auto& c : _x_storage) c = geo_radians(c);
+            for (auto& c : _y_storage) c = geo_radians(c);
+        }
+        point_to_storage();
+    }
+
+    // view of num_cities coordinates kept elsewhere (a cache file, for instance), in the form returned
+    // by x() and y(); they are not copied and must outlive the oracle
+    CoordinateDistance(metric_t metric, unsigned int num_cities, const double* x, const double* y):
+        _metric(metric),
+        _size(num_cities),
+        _x(x),
+        _y(y){
+    }
+
+    CoordinateDistance(const CoordinateDistance& other):
+        _metric(other._metric),
+        _x_storage(other._x_storage),
+        _y_storage(other._y_storage){
+        if ( other.owner() ) point_to_storage();
+        else{
+            _size = other._size;
+            _x    = other._x;
+            _y    = other._y;
+        }
+    }
+
+    CoordinateDistance& operator=(const CoordinateDistance& other){
+        if ( this != &other ){
+            CoordinateDistance copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    // moving a vector keeps its buffer, so the pointers stay valid
+    CoordinateDistance(CoordinateDistance&&) noexcept = default;
+    CoordinateDistance& operator=(CoordinateDistance&&) noexcept = default;
+
+    unsigned int size()   const noexcept { return _size; }
+    metric_t     metric() const noexcept { return _metric; }
+    bool         owner()  const noexcept { return !_x_storage.empty(); }
+
+    // coordinates as used by the distance functions: GEO coordinates are in radians
+    const double* x() const noexcept { return _x; }
+    const double* y() const noexcept { return _y; }
+
+    // owning copy where city k is city order[k] of this one
+    CoordinateDistance renumbered(const std::vector<unsigned int>& order) const {
+        CoordinateDistance result;
+        result._metric = _metric;
+        result._x_storage.resize( order.size() );
+        result._y_storage.resize( order.size() );
+        for (std::size_t k = 0; k < order.size(); ++k){
+            result._x_storage[k] = _x[ order[k] ];
+            result._y_storage[k] = _y[ order[k] ];
+        }
+        result.point_to_storage();
+        return result;
+    }
+
+    int operator()(unsigned int i, unsigned int j) const noexcept {
+        switch ( _metric ){
+        case metric_t::euc_2d:  return static_cast<int>( euclidean(i, j) + 0.5 );
+        case metric_t::ceil_2d: return static_cast<int>( std::ceil( euclidean(i, j) ) );
+        case metric_t::geo:     return geo(i, j);
+        case metric_t::att:     return att(i, j);
+        }
+        return 0;
+    }
+
+    // distances from city i to the cities js[0 .. m-1], written to out[0 .. m-1]
+    void distances(unsigned int i, const unsigned int* js, std::size_t m, int* out) const noexcept {
+        std::size_t k = 0;
+        if ( _metric == metric_t::euc_2d || _metric == metric_t::ceil_2d ){
+            const bool ceil = ( _metric == metric_t::ceil_2d );
+#if defined(__AVX2__)
+            const __m256d xi = _mm256_set1_pd( _x[i] ), yi = _mm256_set1_pd( _y[i] ), half = _mm256_set1_pd(0.5);
+            const __m256d zero = _mm256_setzero_pd(), all = _mm256_castsi256_pd( _mm256_set1_epi64x(-1) );
+            for (; k + 4 <= m; k += 4){
+                const __m128i idx = _mm_loadu_si128( reinterpret_cast<const __m128i*>( js + k ) );
+                const __m256d dx  = _mm256_sub_pd( _mm256_mask_i32gather_pd( zero, _x, idx, all, 8 ), xi );
+                const __m256d dy  = _mm256_sub_pd( _mm256_mask_i32gather_pd( zero, _y, idx, all, 8 ), yi );
+                const __m256d d   = _mm256_sqrt_pd( _mm256_add_pd( _mm256_mul_pd(dx,dx), _mm256_mul_pd(dy,dy) ) );
+                const __m256d r   = ceil ? _mm256_ceil_pd(d) : _mm256_add_pd(d, half);
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( out + k ), _mm256_cvttpd_epi32(r) );
+            }
+#elif defined(__SSE2__)
+            const __m128d xi = _mm_set1_pd( _x[i] ), yi = _mm_set1_pd( _y[i] ), half = _mm_set1_pd(0.5);
+            for (; k + 2 <= m; k += 2){
+                const __m128d dx = _mm_sub_pd( _mm_set_pd( _x[ js[k+1] ], _x[ js[k] ] ), xi );
+                const __m128d dy = _mm_sub_pd( _mm_set_pd( _y[ js[k+1] ], _y[ js[k] ] ), yi );
+                const __m128d d  = _mm_sqrt_pd( _mm_add_pd( _mm_mul_pd(dx,dx), _mm_mul_pd(dy,dy) ) );
+                __m128i r;
+                if ( ceil ){
+                    // d >= 0: truncation is floor, plus one where d has a fractional part
+                    r = _mm_cvttpd_epi32(d);
+                    const __m128i frac = _mm_castpd_si128( _mm_cmpgt_pd( d, _mm_cvtepi32_pd(r) ) );
+                    r = _mm_sub_epi32( r, _mm_shuffle_epi32( frac, _MM_SHUFFLE(3,3,2,0) ) );
+                }
+                else r = _mm_cvttpd_epi32( _mm_add_pd(d, half) );
+                _mm_storel_epi64( reinterpret_cast<__m128i*>( out + k ), r );
+            }
+#endif
+        }
+        for (; k < m; ++k) out[k] = (*this)(i, js[k]);
+    }
+
+private:
+
+    double euclidean(unsigned int i, unsigned int j) const noexcept {
+        const double dx = _x[i] - _x[j], dy = _y[i] - _y[j];
+        return std::sqrt( dx * dx + dy * dy );
+    }
+
+    // DDD.MM to radians, with the value of pi used by TSPLIB
+    static double geo_radians(double c) noexcept {
+        const double deg = std::trunc(c);
+        return 3.141592 * ( deg + 5.0 * ( c - deg ) / 3.0 ) / 180.0;
+    }
+
+    int geo(unsigned int i, unsigned int j) const noexcept {
+        if ( i == j ) return 0;     // the formula gives 1 (and acos may see an argument above 1)
+        const double q1 = std::cos( _y[i] - _y[j] );
+        const double q2 = std::cos( _x[i] - _x[j] );
+        const double q3 = std::cos( _x[i] + _x[j] );
+        return static_cast<int>( 6378.388 * std::acos( 0.5 * ( ( 1.0 + q1 ) * q2 - ( 1.0 - q1 ) * q3 ) ) + 1.0 );
+    }
+
+    int att(unsigned int i, unsigned int j) const noexcept {
+        const double dx = _x[i] - _x[j], dy = _y[i] - _y[j];
+        const double r  = std::sqrt( ( dx * dx + dy * dy ) / 10.0 );
+        const int    t  = static_cast<int>( r + 0.5 );
+        return t < r ? t + 1 : t;
+    }
+
+    void point_to_storage() noexcept {
+        _size = static_cast<unsigned int>( _x_storage.size() );
+        _x    = _x_storage.data();
+        _y    = _y_storage.data();
+    }
+
+    metric_t      _metric = metric_t::euc_2d;
+    coordinates_t _x_storage;
+    coordinates_t _y_storage;
+    unsigned int  _size = 0;
+    const double* _x = nullptr;
+    const double* _y = nullptr;
+};
+
+}
+}
+}
+
+#endif // TSP_COORDINATES_HPP
@@ -0,0 +1,85 @@
+#ifndef TSP_DISTANCE_HPP
+#define TSP_DISTANCE_HPP
+
+#include "onion/TypeTraits.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace onion{
+namespace cops {
+namespace tsp {
+
+// TSP operators do not depend on a particular container for the problem data.
+// They read the distance between cities i and j through distance(data,i,j), which accepts:
+//
+// - nested containers with a subscript operator: data[i][j] (std::vector<std::vector<T>>, T[N][N] ...)
+// - nested containers with at() only: data.at(i).at(j)
+// - distance oracles, which compute or look up the distance: data(i,j)
+//   (see packed_matrix.hpp, coordinates.hpp and nearest_cache.hpp)
+//
+// Distances are assumed to be symmetric: distance(data,i,j) == distance(data,j,i).
+
+template< typename problem_data_t,
+          typename std::enable_if< has_subscript_operator<const problem_data_t&>, int >::type = 0 >
+inline auto distance(const problem_data_t& data, unsigned int i, unsigned int j){
+    return data[i][j];
+}
+
+template< typename problem_data_t,
+          typename std::enable_if< !has_subscript_operator<const problem_data_t&> &&
+                                    has_member_at<const problem_data_t&>, int >::type = 0 >
+inline auto distance(const problem_data_t& data, unsigned int i, unsigned int j){
+    return data.at(i).at(j);
+}
+
+template< typename problem_data_t,
+          typename std::enable_if< !has_subscript_operator<const problem_data_t&> &&
+                                   !has_member_at<const problem_data_t&> &&
+                                    has_binary_call_operator<const problem_data_t&>, int >::type = 0 >
+inline auto distance(const problem_data_t& data, unsigned int i, unsigned int j){
+    return data(i,j);
+}
+
+// Type of a single distance.
+template< typename problem_data_t >
+using distance_t = decltype( distance( std::declval<const problem_data_t&>(), 0u, 0u ) );
+
+// Type used for tour lengths and for their variations (deltas).
+// Integral distances are accumulated in a signed 64-bit integer, so deltas can be negative
+// and long tours do not overflow. Floating point distances keep their type.
+template< typename problem_data_t >
+using cost_t = typename std::conditional< std::is_integral< distance_t<problem_data_t> >::value,
+                                          std::int64_t,
+                                          distance_t<problem_data_t> >::type;
+
+template< typename, typename = void >
+constexpr bool has_batch_distances = false;
+
+template< typename T >
+constexpr bool has_batch_distances< T, void_t< decltype( std::declval<const T&>().distances(
+        0u, std::declval<const unsigned int*>(), std::size_t(0), std::declval< distance_t<T>* >() ) ) > > = true;
+
+// Distances from city i to the cities js[0 .. m-1], written to out[0 .. m-1].
+// Oracles that provide a batch call, data.distances(i,js,m,out), compute several distances at once (SIMD);
+// other problem data is read one distance at a time.
+template< typename problem_data_t,
+          typename std::enable_if< has_batch_distances<problem_data_t>, int >::type = 0 >
+inline void distances(const problem_data_t& data, unsigned int i, const unsigned int* js, std::size_t m,
+                      distance_t<problem_data_t>* out){
+    data.distances(i, js, m, out);
+}
+
+template< typename problem_data_t,
+          typename std::enable_if< !has_batch_distances<problem_data_t>, int >::type = 0 >
+inline void distances(const problem_data_t& data, unsigned int i, const unsigned int* js, std::size_t m,
+                      distance_t<problem_data_t>* out){
+    for (std::size_t k = 0; k < m; ++k) out[k] = distance(data, i, js[k]);
+}
+
+}
+}
+}
+
+#endif // TSP_DISTANCE_HPP
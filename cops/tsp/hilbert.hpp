@@ -0,0 +1,59 @@
+#ifndef TSP_HILBERT_HPP
+#define TSP_HILBERT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace tsp {
+
+// Position of the cell (x,y) along the Hilbert curve that fills a 2^32 x 2^32 grid.
+inline std::uint64_t hilbert_index(std::uint32_t x, std::uint32_t y) noexcept {
+    std::uint64_t d = 0;
+    for (std::uint32_t s = std::uint32_t(1) << 31; s > 0; s >>= 1){
+        const std::uint32_t rx = ( x & s ) ? 1 : 0;
+        const std::uint32_t ry = ( y & s ) ? 1 : 0;
+        d += std::uint64_t(s) * s * ( ( 3 * rx ) ^ ry );
+        // rotate the quadrant so that the curve enters at its origin
+        if ( ry == 0 ){
+            if ( rx == 1 ){
+                x = ~x;
+                y = ~y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+// Cities sorted by their position along a Hilbert curve laid over the bounding box of the points.
+// Cities close on the curve are close in the plane, so visiting them in this order gives a reasonable
+// tour, and renumbering the cities in this order keeps the data of near cities close in memory.
+inline std::vector<unsigned int> hilbert_order(const double* x, const double* y, unsigned int num_cities){
+    std::vector<unsigned int> order(num_cities);
+    if ( num_cities == 0 ) return order;
+
+    const auto bx = std::minmax_element(x, x + num_cities);
+    const auto by = std::minmax_element(y, y + num_cities);
+    const double span  = std::max( *bx.second - *bx.first, *by.second - *by.first );
+    const double scale = span > 0 ? 4294967295.0 / span : 0.0;
+
+    std::vector< std::pair<std::uint64_t, unsigned int> > keys(num_cities);
+    for (unsigned int c = 0; c < num_cities; ++c){
+        const auto gx = static_cast<std::uint32_t>( ( x[c] - *bx.first ) * scale );
+        const auto gy = static_cast<std::uint32_t>( ( y[c] - *by.first ) * scale );
+        keys[c] = std::make_pair( hilbert_index(gx, gy), c );
+    }
+    std::sort( keys.begin(), keys.end() );
+    for (unsigned int k = 0; k < num_cities; ++k) order[k] = keys[k].second;
+    return order;
+}
+
+}
+}
+}
+
+#endif // TSP_HILBERT_HPP
@@ -0,0 +1,160 @@
+#ifndef TSP_INSTANCE_CACHE_HPP
+#define TSP_INSTANCE_CACHE_HPP
+
+#include "candidates.hpp"
+#include "coordinates.hpp"
+#include "packed_matrix.hpp"
+#include "tsplib.hpp"
+#include "../io/binary_file.hpp"
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace tsp {
+
+// Binary cache of the data derived from a TSP instance: coordinates, packed distance matrix,
+// candidate lists and city renumbering.
+//
+// The first run parses the instance, computes what it needs and writes a cache file with write().
+// Later runs open the file with the constructor: it is memory-mapped and the oracles and candidate lists
+// returned by coordinates(), matrix() and candidates() are views of the mapped sections. Nothing is parsed,
+// computed or copied, and processes that open the same file share its pages through the page cache.
+//
+// The file format is versioned (see io::BinaryFile); files of another version are rejected, so that
+// callers can fall back to parsing and write a new cache. So are corrupt files: the constructor checks that
+// the header holds a known metric and a dimension that fits in an unsigned int, the size of each section,
+// that the offsets of the candidate lists are increasing and within their section, and that the neighbours
+// and the renumbering are cities, since they are later used as indices unchecked.
+//
+// Renumbering: cities are often renumbered before the cache is built (along a Hilbert curve, for instance,
+// see hilbert.hpp), so that cities close in the plane are close in memory. renumbering()[k] is then the
+// original number of city k; tours found on the cached data are mapped back through it.
+
+class InstanceCache{
+public:
+
+    static const std::uint32_t version = 1;
+
+    // Writes the coordinates and matrix of instance (the ones it holds), the candidate lists and,
+    // unless it is empty, the renumbering. Throws std::runtime_error on failure.
+    static void write(const std::string& path, const tsplib_t& instance, const CandidateList& candidates,
+                      const std::vector<unsigned int>& renumbering = std::vector<unsigned int>()){
+        const std::uint64_t metric = static_cast<std::uint64_t>( instance.coordinates.metric() );
+        const std::uint64_t header[] = { instance.dimension, metric, instance.explicit_weights ? 1u : 0u };
+
+        io::BinaryWriter out(magic(), version);
+        out.add( section_header, header, 3 );
+        out.add( section_name, instance.name.data(), instance.name.size() );
+        if ( instance.coordinates.size() ){
+            out.add( section_x, instance.coordinates.x(), instance.coordinates.size() );
+            out.add( section_y, instance.coordinates.y(), instance.coordinates.size() );
+        }
+        if ( instance.matrix.size() ){
+            out.add( section_matrix, instance.matrix.values(), PackedMatrix<std::uint32_t>::packed_size( instance.matrix.size() ) );
+        }
+        if ( candidates.size() ){
+            out.add( section_offsets,    candidates.offsets(),    std::size_t(candidates.size()) + 1 );
+            out.add( section_neighbours, candidates.neighbours(), candidates.num_neighbours() );
+        }
+        if ( !renumbering.empty() ) out.add( section_renumbering, renumbering.data(), renumbering.size() );
+        out.write(path);
+    }
+
+    // Maps a cache file. Throws std::runtime_error if it cannot be read, is corrupt or was written by another version.
+    explicit InstanceCache(const std::string& path):
+        _file(path, magic(), version){
+        const std::uint64_t* header = _file.section<std::uint64_t>(section_header);
+        if ( _file.count(section_header) != 3 || header[0] > std::numeric_limits<unsigned int>::max() ||
+             header[1] > static_cast<std::uint64_t>( metric_t::att ) ) throw std::runtime_error("InstanceCache: corrupt header in " + path);
+        _dimension        = static_cast<unsigned int>( header[0] );
+        _explicit_weights = header[2] != 0;
+        _name.assign( _file.section<char>(section_name), _file.count(section_name) );
+
+        if ( _file.has(section_x) ){
+            check(section_x, _dimension, path);
+            check(section_y, _dimension, path);
+            _coordinates = CoordinateDistance( static_cast<metric_t>( header[1] ), _dimension,
+                                               _file.section<double>(section_x), _file.section<double>(section_y) );
+        }
+        if ( _file.has(section_matrix) ){
+            check(section_matrix, PackedMatrix<std::uint32_t>::packed_size(_dimension), path);
+            _matrix = PackedMatrix<std::uint32_t>( _dimension, _file.section<std::uint32_t>(section_matrix) );
+        }
+        if ( _file.has(section_offsets) ){
+            check(section_offsets, std::size_t(_dimension) + 1, path);
+            const unsigned int* offsets = _file.section<unsigned int>(section_offsets);
+            check(section_neighbours, offsets[_dimension], path);
+            const unsigned int* neighbours = _file.section<unsigned int>(section_neighbours);
+            check_candidates(offsets, neighbours, path);
+            _candidates = CandidateList( _dimension, offsets, neighbours );
+        }
+        if ( _file.has(section_renumbering) ){
+            check(section_renumbering, _dimension, path);
+            _renumbering = _file.section<unsigned int>(section_renumbering);
+            check_cities(section_renumbering, _renumbering, _dimension, path);
+        }
+    }
+
+    const std::string& name()             const noexcept { return _name; }
+    unsigned int       dimension()        const noexcept { return _dimension; }
+    bool               explicit_weights() const noexcept { return _explicit_weights; }
+
+    bool has_coordinates() const noexcept { return _coordinates.size() != 0; }
+    bool has_matrix()      const noexcept { return _matrix.size() != 0; }
+    bool has_candidates()  const noexcept { return _candidates.size() != 0; }
+
+    const CoordinateDistance&          coordinates() const noexcept { return _coordinates; }
+    const PackedMatrix<std::uint32_t>& matrix()      const noexcept { return _matrix; }
+    const CandidateList&               candidates()  const noexcept { return _candidates; }
+
+    // original number of each city, nullptr if the cities were not renumbered
+    const unsigned int* renumbering() const noexcept { return _renumbering; }
+
+private:
+
+    enum : std::uint32_t {
+        section_header = 1, section_name, section_x, section_y, section_matrix,
+        section_offsets, section_neighbours, section_renumbering
+    };
+
+    static const char* magic() noexcept { return "ONIONTSP"; }
+
+    void check(std::uint32_t id, std::size_t expected, const std::string& path) const {
+        if ( _file.count(id) != expected ) throw std::runtime_error("InstanceCache: corrupt section " + std::to_string(id) + " in " + path);
+    }
+
+    // the lists are read without bounds checks: the offsets must start at 0 and never decrease (the last one
+    // is the size of the neighbours section), and every neighbour must be a city
+    void check_candidates(const unsigned int* offsets, const unsigned int* neighbours, const std::string& path) const {
+        if ( offsets[0] != 0 ) throw std::runtime_error("InstanceCache: corrupt section " + std::to_string(section_offsets) + " in " + path);
+        for (unsigned int i = 0; i < _dimension; ++i){
+            if ( offsets[i] > offsets[i + 1] ) throw std::runtime_error("InstanceCache: corrupt section " + std::to_string(section_offsets) + " in " + path);
+        }
+        check_cities(section_neighbours, neighbours, offsets[_dimension], path);
+    }
+
+    void check_cities(std::uint32_t id, const unsigned int* cities, std::size_t count, const std::string& path) const {
+        for (std::size_t k = 0; k < count; ++k){
+            if ( cities[k] >= _dimension ) throw std::runtime_error("InstanceCache: corrupt section " + std::to_string(id) + " in " + path);
+        }
+    }
+
+    io::BinaryFile              _file;
+    std::string                 _name;
+    unsigned int                _dimension = 0;
+    bool                        _explicit_weights = false;
+    CoordinateDistance          _coordinates;
+    PackedMatrix<std::uint32_t> _matrix;
+    CandidateList               _candidates;
+    const unsigned int*         _renumbering = nullptr;
+};
+
+}
+}
+}
+
+#endif // TSP_INSTANCE_CACHE_HPP
@@ -0,0 +1,229 @@
+#ifndef TSP_KDTREE_HPP
+#define TSP_KDTREE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace tsp {
+
+// 2-D k-d tree over the cities of an instance, with deletion (Bentley, "K-d trees for semidynamic point sets").
+//
+// The tree is built once, in O(n log n), by splitting the cities at the median of the coordinate with the
+// larger spread; leaves hold up to bucket_size cities. Cities can then be erased (and all restored with
+// reset()): each node counts its active cities, so empty subtrees are skipped by the searches.
+//
+// nearest() and k_nearest() return active cities in increasing Euclidean distance, O(log n) on average.
+// They do not modify the tree: several threads can search the same tree as long as none erases cities.
+// The tree works on plane coordinates (EUC_2D, CEIL_2D, ATT, see coordinates.hpp); for GEO coordinates it is
+// only an approximation of the great circle distance.
+
+class KdTree{
+public:
+
+    enum : unsigned int { none = ~0u };
+
+    // searches restricted to a quadrant around the query city: bit 0 set for x below the city, bit 1 for
+    // y below it (a city with the same x or y as the query is on the upper side); any for the whole plane
+    enum : int { any = -1 };
+
+    KdTree(const double* x, const double* y, unsigned int num_cities, unsigned int bucket_size = 8):
+        _x(x),
+        _y(y),
+        _bucket_size( std::max(bucket_size, 1u) ),
+        _cities(num_cities),
+        _where(num_cities),
+        _leaf(num_cities){
+        for (unsigned int c = 0; c < num_cities; ++c) _cities[c] = c;
+        _nodes.reserve( 2 * ( num_cities / _bucket_size + 1 ) );
+        if ( num_cities ) build(0, num_cities, none);
+        _px.resize(num_cities);
+        _py.resize(num_cities);
+        for (unsigned int k = 0; k < num_cities; ++k){
+            _where[ _cities[k] ] = k;
+            _px[k] = _x[ _cities[k] ];
+            _py[k] = _y[ _cities[k] ];
+        }
+    }
+
+    unsigned int size()   const noexcept { return static_cast<unsigned int>( _cities.size() ); }
+    unsigned int active() const noexcept { return _nodes.empty() ? 0 : _nodes[0].count; }
+
+    bool contains(unsigned int c) const noexcept {
+        const node_t& leaf = _nodes[ _leaf[c] ];
+        return _where[c] < leaf.first + leaf.count;
+    }
+
+    // removes city c from the searches
+    void erase(unsigned int c) noexcept {
+        if ( !contains(c) ) return;
+        node_t& leaf = _nodes[ _leaf[c] ];
+        // the active cities of a leaf are kept at the front of its range
+        const unsigned int last = leaf.first + leaf.count - 1;
+        const unsigned int d    = _cities[last];
+        std::swap( _cities[ _where[c] ], _cities[last] );
+        std::swap( _px[ _where[c] ], _px[last] );
+        std::swap( _py[ _where[c] ], _py[last] );
+        _where[d] = _where[c];
+        _where[c] = last;
+        for (unsigned int n = _leaf[c]; n != none; n = _nodes[n].parent) --_nodes[n].count;
+    }
+
+    // makes all cities active again
+    void reset() noexcept {
+        for (auto& n : _nodes) n.count = n.size;
+    }
+
+    // nearest active city to city c (c itself excluded), none if there is no such city
+    unsigned int nearest(unsigned int c) const {
+        unsigned int best = none;
+        double       best_d = 0;
+        double       off[2] = { 0.0, 0.0 };
+        if ( active() ) nearest(0, c, 0.0, off, best, best_d);
+        return best;
+    }
+
+    // up to k active cities nearest to city c (c itself excluded) in the given quadrant, nearest first
+    void k_nearest(unsigned int c, unsigned int k, std::vector<unsigned int>& out, int quadrant = any) const {
+        std::vector< std::pair<double, unsigned int> > heap;
+        heap.reserve(k + 1);
+        double off[2] = { 0.0, 0.0 };
+        if ( k && active() ) k_nearest(0, c, k, quadrant, 0.0, off, heap);
+        out.clear();
+        for (const auto& h : heap) out.push_back(h.second);
+    }
+
+    double distance2(unsigned int a, unsigned int b) const noexcept {
+        const double dx = _x[a] - _x[b], dy = _y[a] - _y[b];
+        return dx * dx + dy * dy;
+    }
+
+private:
+
+    struct node_t{
+        unsigned int first, size;       // range of _cities
+        unsigned int count;             // active cities in the subtree
+        unsigned int left, right, parent;
+        int          dim;               // 0: x, 1: y
+        double       cut;
+    };
+
+    double coordinate(unsigned int c, int dim) const noexcept { return dim ? _y[c] : _x[c]; }
+
+    unsigned int build(unsigned int first, unsigned int last, unsigned int parent){
+        const unsigned int id = static_cast<unsigned int>( _nodes.size() );
+        _nodes.push_back( node_t{ first, last - first, last - first, none, none, parent, 0, 0.0 } );
+
+        if ( last - first <= _bucket_size ){
+            for (unsigned int k = first; k < last; ++k) _leaf[ _cities[k] ] = id;
+            return id;
+        }
+
+        double lo[2] = { _x[ _cities[first] ], _y[ _cities[first] ] }, hi[2] = { lo[0], lo[1] };
+        for (unsigned int k = first + 1; k < last; ++k){
+            const unsigned int c = _cities[k];
+            lo[0] = std::min(lo[0], _x[c]);  hi[0] = std::max(hi[0], _x[c]);
+            lo[1] = std::min(lo[1], _y[c]);  hi[1] = std::max(hi[1], _y[c]);
+        }
+        const int dim = ( hi[1] - lo[1] > hi[0] - lo[0] ) ? 1 : 0;
+
+        const unsigned int middle = first + ( last - first ) / 2;
+        std::nth_element( _cities.begin() + first, _cities.begin() + middle, _cities.begin() + last,
+                          [this, dim](unsigned int a, unsigned int b){ return coordinate(a, dim) < coordinate(b, dim); } );
+
+        const double cut = coordinate( _cities[middle], dim );
+        const unsigned int left  = build(first, middle, id);
+        const unsigned int right = build(middle, last, id);
+        _nodes[id].dim   = dim;
+        _nodes[id].cut   = cut;
+        _nodes[id].left  = left;
+        _nodes[id].right = right;
+        return id;
+    }
+
+    // rd is the squared distance from c to the cell of node id, off[d] the offset along d that it includes
+    // (incremental distance calculation, Arya and Mount)
+    void nearest(unsigned int id, unsigned int c, double rd, double* off, unsigned int& best, double& best_d) const {
+        const node_t& n = _nodes[id];
+        if ( n.count == 0 ) return;
+        if ( n.left == none ){
+            for (unsigned int k = n.first; k < n.first + n.count; ++k){
+                const unsigned int o = _cities[k];
+                const double dx = _px[k] - _x[c], dy = _py[k] - _y[c], d = dx * dx + dy * dy;
+                if ( ( best == none || d < best_d ) && o != c ){ best = o;  best_d = d; }
+            }
+            return;
+        }
+        const double diff = coordinate(c, n.dim) - n.cut;
+        const unsigned int near = diff < 0 ? n.left : n.right, far = diff < 0 ? n.right : n.left;
+        nearest(near, c, rd, off, best, best_d);
+
+        const double old = off[n.dim];
+        const double far_rd = rd - old * old + diff * diff;
+        if ( best == none || far_rd < best_d ){
+            off[n.dim] = diff;
+            nearest(far, c, far_rd, off, best, best_d);
+            off[n.dim] = old;
+        }
+    }
+
+    void k_nearest(unsigned int id, unsigned int c, unsigned int k, int quadrant, double rd, double* off,
+                   std::vector< std::pair<double, unsigned int> >& heap) const {
+        const node_t& n = _nodes[id];
+        if ( n.count == 0 ) return;
+        if ( n.left == none ){
+            for (unsigned int i = n.first; i < n.first + n.count; ++i){
+                const unsigned int o = _cities[i];
+                const double dx = _px[i] - _x[c], dy = _py[i] - _y[c], d = dx * dx + dy * dy;
+                if ( o == c ) continue;
+                if ( quadrant != any && ( ( _px[i] < _x[c] ) | ( ( _py[i] < _y[c] ) << 1 ) ) != quadrant ) continue;
+                if ( heap.size() == k ){
+                    if ( d >= heap.back().first ) continue;
+                    heap.pop_back();
+                }
+                // k is small: insertion in a sorted array beats a binary heap
+                auto it = heap.end();
+                heap.emplace_back(d, o);
+                for (; it != heap.begin() && ( it - 1 )->first > d; --it) *it = *( it - 1 );
+                *it = std::make_pair(d, o);
+            }
+            return;
+        }
+        const double diff = coordinate(c, n.dim) - n.cut;
+        const unsigned int near = diff < 0 ? n.left : n.right, far = diff < 0 ? n.right : n.left;
+
+        // the left child holds coordinates up to the cut, the right one from the cut on:
+        // one of them may lie entirely outside the quadrant
+        unsigned int outside = none;
+        if ( quadrant != any ) outside = ( quadrant >> n.dim & 1 ) ? ( diff <= 0 ? n.right : none )
+                                                                  : ( diff > 0 ? n.left : none );
+
+        if ( near != outside ) k_nearest(near, c, k, quadrant, rd, off, heap);
+
+        const double old = off[n.dim];
+        const double far_rd = rd - old * old + diff * diff;
+        if ( far != outside && ( heap.size() < k || far_rd < heap.back().first ) ){
+            off[n.dim] = diff;
+            k_nearest(far, c, k, quadrant, far_rd, off, heap);
+            off[n.dim] = old;
+        }
+    }
+
+    const double*             _x;
+    const double*             _y;
+    unsigned int              _bucket_size;
+    std::vector<node_t>       _nodes;
+    std::vector<unsigned int> _cities;  // permutation of the cities, leaves own contiguous ranges
+    std::vector<unsigned int> _where;   // position of each city in _cities
+    std::vector<unsigned int> _leaf;    // leaf of each city
+    std::vector<double>       _px, _py; // coordinates in the order of _cities: leaves are scanned contiguously
+};
+
+}
+}
+}
+
+#endif // TSP_KDTREE_HPP
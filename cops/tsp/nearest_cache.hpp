@@ -0,0 +1,68 @@
+#ifndef TSP_NEAREST_CACHE_HPP
+#define TSP_NEAREST_CACHE_HPP
+
+#include "candidates.hpp"
+#include "distance.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace tsp {
+
+// Distance oracle that caches the distances from each city to its candidate neighbours.
+//
+// Improvement moves read mostly d(a,c) for c in the candidate list of a, and most edges of a good tour join
+// near neighbours. The cache keeps these k.n distances in an array parallel to the CSR candidate array,
+// so a lookup scans the (short, contiguous) candidate list of i; other distances are read from the
+// underlying problem data. Worth it when the underlying distance is expensive: a GEO CoordinateDistance,
+// a matrix that does not fit in the cache ...
+//
+// The problem data and the candidate lists are not copied and must outlive the cache.
+
+template< typename problem_data_t >
+class NearestCache{
+public:
+
+    using value_type = distance_t<problem_data_t>;
+
+    NearestCache(const problem_data_t& data, const CandidateList& candidates):
+        _data(data),
+        _candidates(candidates),
+        _cached( candidates.num_neighbours() ){
+        for (unsigned int i = 0; i < candidates.size(); ++i){
+            const std::size_t offset = candidates.offsets()[i];
+            tsp::distances( data, i, candidates.begin(i), candidates.degree(i), _cached.data() + offset );
+        }
+    }
+
+    // distance to the k-th candidate of city c
+    value_type candidate(unsigned int c, unsigned int k) const noexcept {
+        return _cached[ _candidates.offsets()[c] + k ];
+    }
+
+    value_type operator()(unsigned int i, unsigned int j) const {
+        const unsigned int* first = _candidates.begin(i);
+        const unsigned int  n     = _candidates.degree(i);
+        for (unsigned int k = 0; k < n; ++k){
+            if ( first[k] == j ) return _cached[ _candidates.offsets()[i] + k ];
+        }
+        return distance(_data, i, j);
+    }
+
+    void distances(unsigned int i, const unsigned int* js, std::size_t m, value_type* out) const {
+        tsp::distances(_data, i, js, m, out);
+    }
+
+private:
+
+    const problem_data_t&   _data;
+    const CandidateList&    _candidates;
+    std::vector<value_type> _cached;
+};
+
+}
+}
+}
+
+#endif // TSP_NEAREST_CACHE_HPP
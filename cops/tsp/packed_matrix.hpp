@@ -0,0 +1,129 @@
+#ifndef TSP_PACKED_MATRIX_HPP
+#define TSP_PACKED_MATRIX_HPP
+
+#include "distance.hpp"
+#include "onion/AlignedAllocator.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace tsp {
+
+// Distance oracle backed by the strict upper triangle of a symmetric distance matrix.
+//
+// Only the n(n-1)/2 distances d(i,j), i < j, are stored, row after row, in a single aligned array;
+// the diagonal is 0. With value_t = uint16_t this is 1/4 of the memory of a full matrix of int
+// (1/8 against a matrix of 64-bit values), so many more rows fit in the cache. value_t is usually:
+//
+// - std::uint16_t : integral distances up to 65535 (reduced precision: scale the instance if needed)
+// - std::uint32_t : integral distances
+// - float         : real distances with 24 bits of precision
+//
+// The matrix either owns its storage or is a view of packed values kept elsewhere (a mapped file, for
+// instance); a view does not copy nor free them.
+
+template< typename value_t >
+class PackedMatrix{
+public:
+
+    using value_type = value_t;
+
+    PackedMatrix() = default;
+
+    // owning matrix of num_cities cities, all distances 0
+    explicit PackedMatrix(unsigned int num_cities):
+        _num_cities(num_cities),
+        _storage( packed_size(num_cities), value_t(0) ),
+        _values(_storage.data()){
+    }
+
+    // view of packed_size(num_cities) values laid out as described above
+    PackedMatrix(unsigned int num_cities, const value_t* values):
+        _num_cities(num_cities),
+        _values(values){
+    }
+
+    PackedMatrix(const PackedMatrix& other):
+        _num_cities(other._num_cities),
+        _storage(other._storage),
+        _values( other.owner() ? _storage.data() : other._values ){
+    }
+
+    PackedMatrix& operator=(const PackedMatrix& other){
+        if ( this != &other ){
+            _num_cities = other._num_cities;
+            _storage    = other._storage;
+            _values     = other.owner() ? _storage.data() : other._values;
+        }
+        return *this;
+    }
+
+    // moving a vector keeps its buffer, so _values stays valid
+    PackedMatrix(PackedMatrix&&) noexcept = default;
+    PackedMatrix& operator=(PackedMatrix&&) noexcept = default;
+
+    static std::size_t packed_size(unsigned int num_cities) noexcept {
+        return static_cast<std::size_t>(num_cities) * ( num_cities ? num_cities - 1 : 0 ) / 2;
+    }
+
+    unsigned int    size()   const noexcept { return _num_cities; }
+    bool            owner()  const noexcept { return !_storage.empty(); }
+    const value_t*  values() const noexcept { return _values; }
+
+    value_t operator()(unsigned int i, unsigned int j) const noexcept {
+        if ( i == j ) return value_t(0);
+        return _values[ index(i, j) ];
+    }
+
+    // only for owning matrices
+    void set(unsigned int i, unsigned int j, value_t d) noexcept {
+        if ( i != j ) _storage[ index(i, j) ] = d;
+    }
+
+    // owning copy where city k is city order[k] of this one
+    PackedMatrix renumbered(const std::vector<unsigned int>& order) const {
+        const unsigned int n = static_cast<unsigned int>( order.size() );
+        PackedMatrix result(n);
+        for (unsigned int i = 0; i < n; ++i)
+            for (unsigned int j = i + 1; j < n; ++j) result.set( i, j, (*this)( order[i], order[j] ) );
+        return result;
+    }
+
+private:
+
+    // row i holds d(i,i+1) .. d(i,n-1) and starts after the n-1 + n-2 + ... + n-i values of the previous rows
+    std::size_t index(unsigned int i, unsigned int j) const noexcept {
+        if ( i > j ) std::swap(i, j);
+        const std::size_t r = i;
+        return r * ( 2 * std::size_t(_num_cities) - r - 1 ) / 2 + ( j - i - 1 );
+    }
+
+    unsigned int                                            _num_cities = 0;
+    std::vector< value_t, onion::AlignedAllocator<value_t> > _storage;
+    const value_t*                                          _values = nullptr;
+};
+
+// Packs the distances of num_cities cities, read from any problem data (see distance.hpp), in a PackedMatrix.
+// Distances are converted to value_t with static_cast: value_t must be able to hold the largest one.
+template< typename value_t, typename problem_data_t >
+PackedMatrix<value_t> pack(const problem_data_t& data, unsigned int num_cities){
+    PackedMatrix<value_t> matrix(num_cities);
+    std::vector<unsigned int> cities(num_cities);
+    std::vector< distance_t<problem_data_t> > row(num_cities);
+    for (unsigned int j = 0; j < num_cities; ++j) cities[j] = j;
+
+    for (unsigned int i = 0; i + 1 < num_cities; ++i){
+        distances(data, i, cities.data() + i + 1, num_cities - i - 1, row.data());
+        for (unsigned int j = i + 1; j < num_cities; ++j) matrix.set( i, j, static_cast<value_t>( row[j - i - 1] ) );
+    }
+    return matrix;
+}
+
+}
+}
+}
+
+#endif // TSP_PACKED_MATRIX_HPP
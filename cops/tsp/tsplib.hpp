@@ -0,0 +1,177 @@
+#ifndef TSP_TSPLIB_HPP
+#define TSP_TSPLIB_HPP
+
+#include "coordinates.hpp"
+#include "packed_matrix.hpp"
+#include "../io/mapped_file.hpp"
+#include "../io/scanner.hpp"
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace onion{
+namespace cops {
+namespace tsp {
+
+// A symmetric TSP instance read from a TSPLIB file.
+//
+// Depending on EDGE_WEIGHT_TYPE, the distances are given either by coordinates or by an explicit matrix;
+// the matching member is filled and is ready to be used as problem data (see distance.hpp):
+//
+// - EUC_2D, CEIL_2D, GEO, ATT : coordinates (CoordinateDistance)
+// - EXPLICIT                  : matrix (PackedMatrix<std::uint32_t>)
+
+struct tsplib_t{
+    std::string                 name;
+    std::string                 comment;
+    unsigned int                dimension = 0;
+    bool                        explicit_weights = false;
+    CoordinateDistance          coordinates;
+    PackedMatrix<std::uint32_t> matrix;
+};
+
+namespace detail{
+
+inline bool tsplib_metric(const std::string& type, metric_t& metric){
+    if      ( type == "EUC_2D" )  metric = metric_t::euc_2d;
+    else if ( type == "CEIL_2D" ) metric = metric_t::ceil_2d;
+    else if ( type == "GEO" )     metric = metric_t::geo;
+    else if ( type == "ATT" )     metric = metric_t::att;
+    else return false;
+    return true;
+}
+
+// DIMENSION: a positive number of cities, alone on its line
+inline unsigned int tsplib_dimension(const std::string& value, const std::string& path){
+    const bool digits = !value.empty() && value.find_first_not_of("0123456789") == std::string::npos;
+    // at most 10 digits: the value fits in the 64-bit integer of the scanner
+    if ( digits && value.size() <= 10 ){
+        io::Scanner in( value.data(), value.data() + value.size() );
+        const std::int64_t n = in.integer();
+        if ( n >= 1 && n <= std::numeric_limits<unsigned int>::max() ) return static_cast<unsigned int>(n);
+    }
+    throw std::runtime_error("TSPLIB: invalid DIMENSION '" + value + "' in " + path);
+}
+
+// NODE_COORD_SECTION: one "id x y" line per city, ids from 1 to dimension, each once
+inline CoordinateDistance tsplib_coordinates(io::Scanner& in, unsigned int dimension, metric_t metric, const std::string& path){
+    CoordinateDistance::coordinates_t x(dimension), y(dimension);
+    std::vector<bool> seen(dimension);
+    for (unsigned int k = 0; k < dimension; ++k){
+        const std::int64_t id = in.integer();
+        if ( id < 1 || id > dimension ) throw std::runtime_error("TSPLIB: node id out of range in NODE_COORD_SECTION of " + path);
+        if ( seen[id - 1] ) throw std::runtime_error("TSPLIB: duplicate node id " + std::to_string(id) + " in NODE_COORD_SECTION of " + path);
+        seen[id - 1] = true;
+        x[id - 1] = in.real();
+        y[id - 1] = in.real();
+    }
+    return CoordinateDistance( metric, std::move(x), std::move(y) );
+}
+
+// EDGE_WEIGHT_SECTION: the values are read in file order and the ones above the diagonal are stored
+inline PackedMatrix<std::uint32_t> tsplib_matrix(io::Scanner& in, unsigned int n, const std::string& format,
+                                                 const std::string& path){
+    PackedMatrix<std::uint32_t> matrix(n);
+    auto value = [&in, &path](){
+        const std::int64_t v = in.integer();
+        if ( v < 0 || v > 0xFFFFFFFFll ) throw std::runtime_error("TSPLIB: edge weight out of range in " + path);
+        return static_cast<std::uint32_t>(v);
+    };
+
+    if ( format == "FULL_MATRIX" ){
+        for (unsigned int i = 0; i < n; ++i)
+            for (unsigned int j = 0; j < n; ++j){
+                const std::uint32_t v = value();
+                if ( i < j ) matrix.set(i, j, v);
+            }
+    }
+    else if ( format == "UPPER_ROW" || format == "UPPER_DIAG_ROW" ){
+        const unsigned int diagonal = ( format == "UPPER_DIAG_ROW" );
+        for (unsigned int i = 0; i < n; ++i)
+            for (unsigned int j = i + 1 - diagonal; j < n; ++j){
+                const std::uint32_t v = value();
+                if ( j != i ) matrix.set(i, j, v);
+            }
+    }
+    else if ( format == "LOWER_ROW" || format == "LOWER_DIAG_ROW" ){
+        const unsigned int diagonal = ( format == "LOWER_DIAG_ROW" );
+        for (unsigned int i = 0; i < n; ++i)
+            for (unsigned int j = 0; j < i + diagonal; ++j){
+                const std::uint32_t v = value();
+                if ( j != i ) matrix.set(i, j, v);
+            }
+    }
+    else throw std::runtime_error("TSPLIB: unsupported EDGE_WEIGHT_FORMAT " + format + " in " + path);
+    return matrix;
+}
+
+}
+
+// Reads a symmetric TSP instance (TYPE: TSP) in TSPLIB format.
+//
+// The file is memory-mapped and parsed in a single pass with io::Scanner; coordinates and weights are written
+// straight into the structures used by the operators, with no intermediate containers.
+// Supported: EDGE_WEIGHT_TYPE EUC_2D, CEIL_2D, GEO, ATT and EXPLICIT, with EDGE_WEIGHT_FORMAT FULL_MATRIX,
+// UPPER_ROW, UPPER_DIAG_ROW, LOWER_ROW and LOWER_DIAG_ROW. Other sections (DISPLAY_DATA_SECTION ...) are ignored.
+//
+// Throws std::runtime_error if the file cannot be read, is malformed or uses an unsupported feature.
+inline tsplib_t read_tsplib(const std::string& path){
+    const io::MappedFile file(path);
+    io::Scanner in( file.begin(), file.end(), path );
+
+    tsplib_t    instance;
+    std::string weight_type, weight_format;
+    bool        has_weights = false;
+
+    while ( !in.eof() ){
+        std::string line = in.line();
+        if ( line.empty() ) continue;
+
+        // "KEY : value", "KEY: value" or a section name
+        std::string key = line, value;
+        const auto colon = line.find(':');
+        if ( colon != std::string::npos ){
+            key   = line.substr(0, colon);
+            value = line.substr(colon + 1);
+            value.erase( 0, value.find_first_not_of(" \t") );
+        }
+        key.erase( key.find_last_not_of(" \t") + 1 );
+
+        if      ( key == "NAME" )               instance.name = value;
+        else if ( key == "COMMENT" )            instance.comment += instance.comment.empty() ? value : "\n" + value;
+        else if ( key == "DIMENSION" )          instance.dimension = detail::tsplib_dimension(value, path);
+        else if ( key == "EDGE_WEIGHT_TYPE" )   weight_type   = value;
+        else if ( key == "EDGE_WEIGHT_FORMAT" ) weight_format = value;
+        else if ( key == "TYPE" ){
+            if ( value.compare(0, 3, "TSP") != 0 ) throw std::runtime_error("TSPLIB: unsupported TYPE " + value + " in " + path);
+        }
+        else if ( key == "NODE_COORD_SECTION" ){
+            metric_t metric;
+            if ( !detail::tsplib_metric(weight_type, metric) )
+                throw std::runtime_error("TSPLIB: unsupported EDGE_WEIGHT_TYPE " + weight_type + " in " + path);
+            if ( !instance.dimension ) throw std::runtime_error("TSPLIB: no DIMENSION before NODE_COORD_SECTION in " + path);
+            instance.coordinates = detail::tsplib_coordinates(in, instance.dimension, metric, path);
+            has_weights = true;
+        }
+        else if ( key == "EDGE_WEIGHT_SECTION" ){
+            if ( weight_type != "EXPLICIT" ) throw std::runtime_error("TSPLIB: EDGE_WEIGHT_SECTION without EXPLICIT weights in " + path);
+            if ( !instance.dimension ) throw std::runtime_error("TSPLIB: no DIMENSION before EDGE_WEIGHT_SECTION in " + path);
+            instance.matrix = detail::tsplib_matrix(in, instance.dimension, weight_format, path);
+            instance.explicit_weights = true;
+            has_weights = true;
+        }
+        else if ( key == "EOF" ) break;
+    }
+
+    if ( !has_weights ) throw std::runtime_error("TSPLIB: no NODE_COORD_SECTION nor EDGE_WEIGHT_SECTION in " + path);
+    return instance;
+}
+
+}
+}
+}
+
+#endif // TSP_TSPLIB_HPP
@@ -0,0 +1,194 @@
+/** @file onion/tests/random_distributions.cpp
+ *  @brief Statistical tests of the conversions of RandomDistributions.hpp and of the engines that use them.
+ *
+ *  Each test draws from a fixed seed and bins the results; the chi-square statistic against the uniform
+ *  distribution is reported as z = (chi2 - df) / sqrt(2 df), which is approximately normal for a correct
+ *  conversion. A test fails when |z| > 4, so a run is deterministic and a correct build passes.
+ *
+ *  - bounded_int(): small ranges, odd ranges and ranges near 2<sup>32</sup>, where `x % range` is visibly
+ *    biased (the test checks that it detects that bias), and with 15-bit words, as RandomLegacyC uses it.
+ *  - real_01(): every value in [0,1), the extreme words, and uniformity over 100 bins.
+ *  - uniform_int_between() and uniform_real_01() of RandomXoshiro256 and RandomSTL<std::mt19937>, single
+ *    draws and fill_*.
+ *
+ *  Build and run, from the directory that contains the framework as onion/:
+ *
+ *      g++ -std=c++14 -O2 -I. onion/tests/random_distributions.cpp -o random_distributions && ./random_distributions
+ *
+ *  The exit status is the number of failed tests.
+ *  <hr>
+ *  @copyright 2022 André Ladeira / Onion Framework.
+ */
+#include "onion/RandomDistributions.hpp"
+#include "onion/RandomSTL.hpp"
+#include "onion/RandomXoshiro.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace onion;
+
+namespace {
+
+int failures = 0;
+
+// z score of the chi-square statistic of counts against equal expectations
+double chi_square_z(const std::vector<std::uint64_t>& counts){
+    std::uint64_t total = 0;
+    for (auto c : counts) total += c;
+    const double expected = double(total) / counts.size();
+    double chi2 = 0;
+    for (auto c : counts) chi2 += ( c - expected ) * ( c - expected ) / expected;
+    const double df = double(counts.size() - 1);
+    return ( chi2 - df ) / std::sqrt( 2 * df );
+}
+
+void report(const char* name, bool pass){
+    std::printf( "%s  %s\n", pass ? "PASS" : "FAIL", name );
+    if ( !pass ) ++failures;
+}
+
+void report(const char* name, bool pass, double z){
+    std::printf( "%s  %-60s z = %8.2f\n", pass ? "PASS" : "FAIL", name, z );
+    if ( !pass ) ++failures;
+}
+
+void expect_uniform(const char* name, const std::vector<std::uint64_t>& counts){
+    const double z = chi_square_z(counts);
+    report( name, std::fabs(z) <= 4, z );
+}
+
+// bin of v in [0,range) among bins equal parts; range 0 is the whole 32-bit range
+std::size_t bin(std::uint32_t v, std::uint32_t range, std::size_t bins){
+    const std::uint64_t r = range ? range : std::uint64_t(1) << 32;
+    return static_cast<std::size_t>( std::uint64_t(v) * bins / r );
+}
+
+// draws of draw() in [0,range), binned: one bin per value for small ranges, 64 equal parts otherwise
+template< typename draw_t >
+std::vector<std::uint64_t> histogram(std::uint32_t range, std::size_t n, draw_t&& draw){
+    const std::size_t bins = ( range && range <= 1000 ) ? range : 64;
+    std::vector<std::uint64_t> counts(bins);
+    for (std::size_t k = 0; k < n; ++k){
+        const std::uint32_t v = draw();
+        if ( range && v >= range ){
+            report("value out of range", false);
+            return counts;
+        }
+        ++counts[ bin(v, range, bins) ];
+    }
+    return counts;
+}
+
+void test_bounded_int(){
+    const std::size_t n = 4000000;
+    std::mt19937 words(1);
+    auto next = [&words](){ return static_cast<std::uint32_t>( words() ); };
+
+    const struct { const char* name; std::uint32_t range; } cases[] = {
+        { "bounded_int, range 2",                         2 },
+        { "bounded_int, range 3",                         3 },
+        { "bounded_int, range 7",                         7 },
+        { "bounded_int, range 1000",                   1000 },
+        { "bounded_int, range 2^31 + 1",        0x80000001u },
+        { "bounded_int, range 3 * 2^30",        0xC0000000u },
+        { "bounded_int, range 2^32 - 1",        0xFFFFFFFFu },
+        { "bounded_int, range 0 (2^32)",                  0 },
+    };
+    for (const auto& c : cases){
+        expect_uniform( c.name, histogram( c.range, n, [&](){ return bounded_int(c.range, next); } ) );
+    }
+
+    // the test has the power to see the bias that bounded_int() removes: with range 3 * 2^30, x % range
+    // falls in the first third twice as often as in the others
+    {
+        const std::uint32_t range = 0xC0000000u;
+        const double z = chi_square_z( histogram( range, n, [&](){ return next() % range; } ) );
+        report( "x % range, range 3 * 2^30, is detected as biased", z > 4, z );
+    }
+
+    // 15-bit words, as drawn from rand() on some platforms
+    {
+        auto next15 = [&words](){ return static_cast<std::uint32_t>( words() & 0x7FFF ); };
+        const std::uint32_t ranges[] = { 3, 1000, 0x7FFF };
+        for (auto range : ranges){
+            char name[64];
+            std::snprintf( name, sizeof(name), "bounded_int<15>, range %u", range );
+            expect_uniform( name, histogram( range, n, [&](){ return bounded_int<15>(range, next15); } ) );
+        }
+    }
+}
+
+void test_real_01(){
+    report( "real_01(0) == 0",                   real_01( std::uint64_t(0) ) == 0.0 );
+    report( "real_01(2^64 - 1) < 1",             real_01( ~std::uint64_t(0) ) < 1.0 );
+    report( "real_01(2^32 - 1, 2^32 - 1) < 1",   real_01( 0xFFFFFFFFu, 0xFFFFFFFFu ) < 1.0 );
+
+    std::mt19937_64 words(2);
+    const std::size_t n = 4000000, bins = 100;
+    std::vector<std::uint64_t> counts(bins);
+    bool inside = true;
+    for (std::size_t k = 0; k < n; ++k){
+        const double x = real_01( static_cast<std::uint64_t>( words() ) );
+        inside &= ( x >= 0.0 && x < 1.0 );
+        ++counts[ static_cast<std::size_t>( x * bins ) % bins ];
+    }
+    report( "real_01 in [0,1)", inside );
+    expect_uniform( "real_01, 100 bins", counts );
+}
+
+// the engines, through the RandomEngine interface
+void test_engine(const char* engine, RandomEngine& rng){
+    const std::size_t n = 2000000;
+    char name[96];
+
+    const struct { RandomEngine::int_t min, max; } intervals[] = { { 0, 6 }, { 1, 1000 }, { 5, 6 } };
+    for (const auto& i : intervals){
+        const std::uint32_t range = i.max - i.min + 1;
+        std::snprintf( name, sizeof(name), "%s uniform_int_between(%u,%u)", engine, i.min, i.max );
+        expect_uniform( name, histogram( range, n, [&](){ return rng.uniform_int_between(i.min, i.max) - i.min; } ) );
+
+        std::vector<RandomEngine::int_t> block(n);
+        rng.fill_uniform_int_between( block.data(), n, i.min, i.max );
+        std::size_t k = 0;
+        std::snprintf( name, sizeof(name), "%s fill_uniform_int_between(%u,%u)", engine, i.min, i.max );
+        expect_uniform( name, histogram( range, n, [&](){ return block[k++] - i.min; } ) );
+    }
+
+    std::vector<RandomEngine::real_t> block(n);
+    rng.fill_uniform_real_01( block.data(), n );
+    std::vector<std::uint64_t> single(100), filled(100);
+    bool inside = true;
+    for (std::size_t k = 0; k < n; ++k){
+        const double x = rng.uniform_real_01();
+        inside &= ( x >= 0.0 && x < 1.0 ) && ( block[k] >= 0.0 && block[k] < 1.0 );
+        ++single[ static_cast<std::size_t>( x * 100 ) % 100 ];
+        ++filled[ static_cast<std::size_t>( block[k] * 100 ) % 100 ];
+    }
+    std::snprintf( name, sizeof(name), "%s uniform_real_01 and fill in [0,1)", engine );
+    report( name, inside );
+    std::snprintf( name, sizeof(name), "%s uniform_real_01, 100 bins", engine );
+    expect_uniform( name, single );
+    std::snprintf( name, sizeof(name), "%s fill_uniform_real_01, 100 bins", engine );
+    expect_uniform( name, filled );
+}
+
+}
+
+int main(){
+    test_bounded_int();
+    test_real_01();
+
+    RandomXoshiro256 xoshiro;
+    xoshiro.seed(3);
+    test_engine( "RandomXoshiro256", xoshiro );
+
+    RandomSTL<std::mt19937> mt;
+    mt.seed(4);
+    test_engine( "RandomSTL<mt19937>", mt );
+
+    std::printf( "%d failed\n", failures );
+    return failures;
+}